@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+
+namespace bench
+{
+    // number of calls to the global operator new made by the process so far
+    size_t allocation_count();
+}
@@ -0,0 +1,218 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "allocation_counter.h"
+#include "bench_utils.h"
+
+namespace
+{
+    // Runs op on operands of the given signs, reporting heap allocations per call.
+    template <typename Op>
+    void run_signed(benchmark::State& state, bool a_negative, bool b_negative, Op op)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer a = bench::random_big_integer(limbs, rng);
+        big_integer b = bench::random_big_integer((limbs + 1) / 2, rng);
+        if (a_negative)
+        {
+            a = -a;
+        }
+        if (b_negative)
+        {
+            b = -b;
+        }
+
+        size_t allocations = 0;
+        for (auto _ : state)
+        {
+            size_t before = bench::allocation_count();
+            benchmark::DoNotOptimize(op(a, b));
+            allocations += bench::allocation_count() - before;
+        }
+        state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocations),
+                                                      benchmark::Counter::kAvgIterations);
+    }
+
+    // Values that fit the inline storage: an a of state.range(0) limbs and a single-limb b.
+    template <typename Op>
+    void run_small(benchmark::State& state, Op op)
+    {
+        std::mt19937 rng(42);
+        big_integer a = -bench::random_big_integer(static_cast<size_t>(state.range(0)), rng);
+        big_integer b = bench::random_big_integer(1, rng);
+
+        size_t allocations = 0;
+        for (auto _ : state)
+        {
+            size_t before = bench::allocation_count();
+            benchmark::DoNotOptimize(op(a, b));
+            allocations += bench::allocation_count() - before;
+        }
+        state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocations),
+                                                      benchmark::Counter::kAvgIterations);
+    }
+
+    void BM_small_add(benchmark::State& state)
+    {
+        run_small(state, [](big_integer const& a, big_integer const& b) { return a + b; });
+    }
+
+    void BM_small_sub(benchmark::State& state)
+    {
+        run_small(state, [](big_integer const& a, big_integer const& b) { return a - b; });
+    }
+
+    void BM_small_mul(benchmark::State& state)
+    {
+        run_small(state, [](big_integer const& a, big_integer const& b) { return a * b; });
+    }
+
+    void BM_small_div(benchmark::State& state)
+    {
+        run_small(state, [](big_integer const& a, big_integer const& b) { return a / b; });
+    }
+
+    void BM_small_compare(benchmark::State& state)
+    {
+        run_small(state, [](big_integer const& a, big_integer const& b) { return a < b; });
+    }
+
+    void BM_small_increment(benchmark::State& state)
+    {
+        run_small(state, [](big_integer& a, big_integer const&) { return ++a; });
+    }
+
+    // shifts of a negative value of state.range(0) limbs by a whole number of limbs or not
+    void run_shift(benchmark::State& state, int shift, bool left)
+    {
+        std::mt19937 rng(42);
+        big_integer a = -bench::random_big_integer(static_cast<size_t>(state.range(0)), rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(left ? a << shift : a >> shift);
+        }
+        state.SetComplexityN(state.range(0));
+    }
+
+    void BM_shl(benchmark::State& state)
+    {
+        run_shift(state, 1000, true);
+    }
+
+    void BM_shl_aligned(benchmark::State& state)
+    {
+        run_shift(state, 1024, true);
+    }
+
+    void BM_shr(benchmark::State& state)
+    {
+        run_shift(state, 1000, false);
+    }
+
+    void BM_shr_aligned(benchmark::State& state)
+    {
+        run_shift(state, 1024, false);
+    }
+
+    // sum of 256 products of state.range(0)-limb values of mixed signs
+    template <typename Accumulate>
+    void run_dot_product(benchmark::State& state, Accumulate accumulate)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        std::vector<big_integer> a, b;
+        for (size_t i = 0; i < 256; ++i)
+        {
+            a.push_back(bench::random_big_integer(limbs, rng));
+            b.push_back(i % 3 == 0 ? -bench::random_big_integer(limbs, rng) : bench::random_big_integer(limbs, rng));
+        }
+
+        size_t allocations = 0;
+        for (auto _ : state)
+        {
+            size_t before = bench::allocation_count();
+            big_integer acc;
+            for (size_t i = 0; i < a.size(); ++i)
+            {
+                accumulate(acc, a[i], b[i]);
+            }
+            allocations += bench::allocation_count() - before;
+            benchmark::DoNotOptimize(acc);
+        }
+        state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocations),
+                                                      benchmark::Counter::kAvgIterations);
+    }
+
+    void BM_dot_product(benchmark::State& state)
+    {
+        run_dot_product(state, [](big_integer& acc, big_integer const& a, big_integer const& b) { acc += a * b; });
+    }
+
+    void BM_dot_product_addmul(benchmark::State& state)
+    {
+        run_dot_product(state, [](big_integer& acc, big_integer const& a, big_integer const& b) { addmul(acc, a, b); });
+    }
+
+    // every intermediate result is a temporary whose buffer the next operator takes over
+    void BM_temporaries_chain(benchmark::State& state)
+    {
+        run_signed(state, false, true, [](big_integer const& a, big_integer const& b) {
+            return (a + b) - (b - a) + (a - b) - (b + a);
+        });
+    }
+
+    void BM_add_mixed_sign(benchmark::State& state)
+    {
+        run_signed(state, false, true, [](big_integer const& a, big_integer const& b) { return a + b; });
+    }
+
+    void BM_sub_mixed_sign(benchmark::State& state)
+    {
+        run_signed(state, true, false, [](big_integer const& a, big_integer const& b) { return a - b; });
+    }
+
+    void BM_mul_mixed_sign(benchmark::State& state)
+    {
+        run_signed(state, true, false, [](big_integer const& a, big_integer const& b) { return a * b; });
+    }
+
+    void BM_mul_both_negative(benchmark::State& state)
+    {
+        run_signed(state, true, true, [](big_integer const& a, big_integer const& b) { return a * b; });
+    }
+
+    void BM_div_mixed_sign(benchmark::State& state)
+    {
+        run_signed(state, true, false, [](big_integer const& a, big_integer const& b) { return a / b; });
+    }
+
+    void BM_div_both_negative(benchmark::State& state)
+    {
+        run_signed(state, true, true, [](big_integer const& a, big_integer const& b) { return a / b; });
+    }
+}
+
+BENCHMARK(BM_small_add)->DenseRange(1, 3);
+BENCHMARK(BM_small_sub)->DenseRange(1, 3);
+BENCHMARK(BM_small_mul)->DenseRange(1, 3);
+BENCHMARK(BM_small_div)->DenseRange(1, 3);
+BENCHMARK(BM_small_compare)->DenseRange(1, 3);
+BENCHMARK(BM_small_increment)->DenseRange(1, 3);
+
+BENCHMARK(BM_shl)->RangeMultiplier(8)->Range(64, 1 << 18)->Complexity();
+BENCHMARK(BM_shl_aligned)->RangeMultiplier(8)->Range(64, 1 << 18)->Complexity();
+BENCHMARK(BM_shr)->RangeMultiplier(8)->Range(64, 1 << 18)->Complexity();
+BENCHMARK(BM_shr_aligned)->RangeMultiplier(8)->Range(64, 1 << 18)->Complexity();
+
+BENCHMARK(BM_dot_product)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK(BM_dot_product_addmul)->RangeMultiplier(4)->Range(1, 256);
+
+BENCHMARK(BM_temporaries_chain)->RangeMultiplier(8)->Range(8, 1 << 12);
+
+BENCHMARK(BM_add_mixed_sign)->RangeMultiplier(8)->Range(1, 1 << 12);
+BENCHMARK(BM_sub_mixed_sign)->RangeMultiplier(8)->Range(1, 1 << 12);
+BENCHMARK(BM_mul_mixed_sign)->RangeMultiplier(8)->Range(1, 1 << 12);
+BENCHMARK(BM_mul_both_negative)->RangeMultiplier(8)->Range(1, 1 << 12);
+BENCHMARK(BM_div_mixed_sign)->RangeMultiplier(8)->Range(1, 1 << 9);
+BENCHMARK(BM_div_both_negative)->RangeMultiplier(8)->Range(1, 1 << 9);
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "../big_integer.h"
+#include "../ci-extra/big_integer_gmp.h"
+
+namespace bench
+{
+    // benchmark sizes count 32-bit words whatever the limb width, so both configurations work on the same numbers
+    constexpr unsigned LIMB_BITS = 32;
+
+    // nonnegative value of exactly `limbs` random 32-bit words, built in O(n log n)
+    inline big_integer random_big_integer(size_t limbs, std::mt19937& rng)
+    {
+        if (limbs == 1)
+        {
+            return big_integer(static_cast<uint32_t>(rng()) | 1U << (LIMB_BITS - 1));
+        }
+        size_t low = limbs / 2;
+        big_integer low_part = random_big_integer(low, rng);
+        return (random_big_integer(limbs - low, rng) << static_cast<int>(LIMB_BITS * low)) | low_part;
+    }
+
+    // random value of the same magnitude in the GMP reference implementation
+    inline big_integer_gmp random_gmp(size_t limbs, std::mt19937& rng)
+    {
+        big_integer_gmp result;
+        result.random(limbs * LIMB_BITS - 1, rng);
+        return result;
+    }
+}
@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "../combinatorics.h"
+#include "bench_utils.h"
+
+namespace
+{
+    void BM_factorial(benchmark::State& state)
+    {
+        auto n = static_cast<uint64_t>(state.range(0));
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(factorial(n));
+        }
+    }
+
+    // running product by *=
+    void BM_factorial_naive(benchmark::State& state)
+    {
+        auto n = static_cast<uint64_t>(state.range(0));
+        for (auto _ : state)
+        {
+            big_integer result = 1;
+            for (uint64_t k = 2; k <= n; ++k)
+            {
+                result *= k;
+            }
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    void BM_factorial_gmp(benchmark::State& state)
+    {
+        auto n = static_cast<unsigned long>(state.range(0));
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(big_integer_gmp::factorial(n));
+        }
+    }
+
+    // end to end, with the decimal conversion of the result
+    void BM_factorial_to_string(benchmark::State& state)
+    {
+        auto n = static_cast<uint64_t>(state.range(0));
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(to_string(factorial(n)));
+        }
+    }
+
+    void BM_factorial_to_string_gmp(benchmark::State& state)
+    {
+        auto n = static_cast<unsigned long>(state.range(0));
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(to_string(big_integer_gmp::factorial(n)));
+        }
+    }
+
+    void BM_binomial(benchmark::State& state)
+    {
+        auto n = static_cast<uint64_t>(state.range(0));
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(binomial(n, n / 2));
+        }
+    }
+
+    void BM_binomial_gmp(benchmark::State& state)
+    {
+        auto n = static_cast<unsigned long>(state.range(0));
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(big_integer_gmp::binomial(n, n / 2));
+        }
+    }
+
+    std::vector<big_integer> random_words(size_t count)
+    {
+        std::mt19937 rng(42);
+        std::vector<big_integer> result;
+        for (size_t i = 0; i < count; ++i)
+        {
+            result.push_back(bench::random_big_integer(1, rng));
+        }
+        return result;
+    }
+
+    void BM_product_tree(benchmark::State& state)
+    {
+        std::vector<big_integer> values = random_words(static_cast<size_t>(state.range(0)));
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(product(values.begin(), values.end()));
+        }
+    }
+
+    void BM_product_running(benchmark::State& state)
+    {
+        std::vector<big_integer> values = random_words(static_cast<size_t>(state.range(0)));
+        for (auto _ : state)
+        {
+            big_integer result = 1;
+            for (big_integer const& x : values)
+            {
+                result *= x;
+            }
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    void factorial_sizes(benchmark::internal::Benchmark* b)
+    {
+        b->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMillisecond);
+    }
+
+    void product_sizes(benchmark::internal::Benchmark* b)
+    {
+        b->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMillisecond);
+    }
+}
+
+BENCHMARK(BM_factorial)->Apply(factorial_sizes);
+BENCHMARK(BM_factorial_naive)->Apply(factorial_sizes);
+BENCHMARK(BM_factorial_gmp)->Apply(factorial_sizes);
+BENCHMARK(BM_factorial_to_string)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_factorial_to_string_gmp)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_binomial)->Apply(factorial_sizes);
+BENCHMARK(BM_binomial_gmp)->Apply(factorial_sizes);
+BENCHMARK(BM_product_tree)->Apply(product_sizes);
+BENCHMARK(BM_product_running)->Apply(product_sizes);
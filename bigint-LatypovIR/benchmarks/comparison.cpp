@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_utils.h"
+
+namespace
+{
+    void set_limbs_rate(benchmark::State& state, size_t limbs)
+    {
+        state.counters["limbs"] = benchmark::Counter(static_cast<double>(limbs),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+    // equal values in distinct objects, the worst case for equality
+    void BM_equal(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer a = bench::random_big_integer(limbs, rng);
+        big_integer b = a;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(a == b);
+        }
+        set_limbs_rate(state, limbs);
+    }
+
+    // values of different length are ordered without reading limbs
+    void BM_less_different_length(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer a = bench::random_big_integer(limbs, rng);
+        big_integer b = bench::random_big_integer(limbs + 1, rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(a < b);
+        }
+    }
+
+    void BM_hash(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer a = bench::random_big_integer(limbs, rng);
+        std::hash<big_integer> hash;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(hash(a));
+        }
+        set_limbs_rate(state, limbs);
+    }
+
+    // lookups of present keys in a map of 2^16 values of state.range(0) limbs
+    void BM_unordered_map_find(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        std::vector<big_integer> keys;
+        std::unordered_map<big_integer, int> map;
+        for (int i = 0; i < (1 << 16); ++i)
+        {
+            keys.push_back(bench::random_big_integer(limbs, rng));
+            map[keys.back()] = i;
+        }
+        size_t i = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(map.find(keys[i++ & 0xffff]));
+        }
+    }
+}
+
+BENCHMARK(BM_equal)->RangeMultiplier(8)->Range(1, 1 << 15);
+BENCHMARK(BM_less_different_length)->RangeMultiplier(8)->Range(1, 1 << 15);
+BENCHMARK(BM_hash)->RangeMultiplier(8)->Range(1, 1 << 15);
+BENCHMARK(BM_unordered_map_find)->RangeMultiplier(4)->Range(1, 64);
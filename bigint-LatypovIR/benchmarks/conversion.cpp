@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+#include "bench_utils.h"
+
+namespace
+{
+    void set_counters(benchmark::State& state, size_t length)
+    {
+        state.SetComplexityN(state.range(0));
+        state.counters["chars"] = benchmark::Counter(static_cast<double>(length),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+    void BM_to_string(benchmark::State& state, int radix)
+    {
+        std::mt19937 rng(42);
+        big_integer a = bench::random_big_integer(static_cast<size_t>(state.range(0)), rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(to_string(a, radix));
+        }
+        set_counters(state, to_string(a, radix).size());
+    }
+
+    void BM_from_string(benchmark::State& state, int radix)
+    {
+        std::mt19937 rng(42);
+        std::string str = to_string(bench::random_big_integer(static_cast<size_t>(state.range(0)), rng), radix);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(big_integer(str, radix));
+        }
+        set_counters(state, str.size());
+    }
+
+    void BM_to_string_gmp(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        big_integer_gmp a = bench::random_gmp(static_cast<size_t>(state.range(0)), rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(to_string(a));
+        }
+        set_counters(state, to_string(a).size());
+    }
+
+    void BM_from_string_gmp(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        std::string str = to_string(bench::random_gmp(static_cast<size_t>(state.range(0)), rng));
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(big_integer_gmp(str));
+        }
+        set_counters(state, str.size());
+    }
+
+    void set_byte_counters(benchmark::State& state, size_t bytes)
+    {
+        state.SetComplexityN(state.range(0));
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+    }
+
+    void BM_to_bytes(benchmark::State& state, byte_order order)
+    {
+        std::mt19937 rng(42);
+        big_integer a = bench::random_big_integer(static_cast<size_t>(state.range(0)), rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(to_bytes(a, order));
+        }
+        set_byte_counters(state, to_bytes(a, order).size());
+    }
+
+    void BM_from_bytes(benchmark::State& state, byte_order order)
+    {
+        std::mt19937 rng(42);
+        std::vector<unsigned char> bytes =
+            to_bytes(bench::random_big_integer(static_cast<size_t>(state.range(0)), rng), order);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(big_integer(bytes.data(), bytes.size(), order));
+        }
+        set_byte_counters(state, bytes.size());
+    }
+
+    // adopting 32-bit words, e.g. from a mapped file
+    void BM_from_words(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        std::vector<uint32_t> words = to_words(bench::random_big_integer(static_cast<size_t>(state.range(0)), rng));
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(big_integer(words.data(), words.size()));
+        }
+        set_byte_counters(state, words.size() * sizeof(uint32_t));
+    }
+
+    void BM_to_bytes_gmp(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        big_integer_gmp a = bench::random_gmp(static_cast<size_t>(state.range(0)), rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(to_bytes(a));
+        }
+        set_byte_counters(state, to_bytes(a).size());
+    }
+
+    void BM_from_bytes_gmp(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        std::vector<unsigned char> bytes = to_bytes(bench::random_gmp(static_cast<size_t>(state.range(0)), rng));
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(big_integer_gmp::from_bytes(bytes.data(), bytes.size()));
+        }
+        set_byte_counters(state, bytes.size());
+    }
+
+    // 10^5 limbs is about a million decimal digits
+    void huge_sizes(benchmark::internal::Benchmark* b)
+    {
+        b->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond)->Iterations(1);
+    }
+}
+
+BENCHMARK_CAPTURE(BM_to_string, decimal, 10)->RangeMultiplier(4)->Range(8, 1 << 14)->Complexity();
+BENCHMARK_CAPTURE(BM_from_string, decimal, 10)->RangeMultiplier(4)->Range(8, 1 << 14)->Complexity();
+BENCHMARK_CAPTURE(BM_to_string, hex, 16)->RangeMultiplier(4)->Range(8, 1 << 14)->Complexity();
+BENCHMARK_CAPTURE(BM_from_string, hex, 16)->RangeMultiplier(4)->Range(8, 1 << 14)->Complexity();
+BENCHMARK(BM_to_string_gmp)->RangeMultiplier(4)->Range(8, 1 << 14)->Complexity();
+BENCHMARK(BM_from_string_gmp)->RangeMultiplier(4)->Range(8, 1 << 14)->Complexity();
+
+BENCHMARK_CAPTURE(BM_to_string, decimal, 10)->Apply(huge_sizes);
+BENCHMARK_CAPTURE(BM_from_string, decimal, 10)->Apply(huge_sizes);
+BENCHMARK(BM_to_string_gmp)->Apply(huge_sizes);
+BENCHMARK(BM_from_string_gmp)->Apply(huge_sizes);
+
+// binary formats against the decimal and hexadecimal strings above
+BENCHMARK_CAPTURE(BM_to_bytes, little_endian, byte_order::little_endian)->RangeMultiplier(4)->Range(8, 1 << 14);
+BENCHMARK_CAPTURE(BM_from_bytes, little_endian, byte_order::little_endian)->RangeMultiplier(4)->Range(8, 1 << 14);
+BENCHMARK_CAPTURE(BM_to_bytes, big_endian, byte_order::big_endian)->RangeMultiplier(4)->Range(8, 1 << 14);
+BENCHMARK_CAPTURE(BM_from_bytes, big_endian, byte_order::big_endian)->RangeMultiplier(4)->Range(8, 1 << 14);
+BENCHMARK(BM_from_words)->RangeMultiplier(4)->Range(8, 1 << 14);
+BENCHMARK(BM_to_bytes_gmp)->RangeMultiplier(4)->Range(8, 1 << 14);
+BENCHMARK(BM_from_bytes_gmp)->RangeMultiplier(4)->Range(8, 1 << 14);
@@ -0,0 +1,136 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <limits>
+
+#include "../magnitude.h"
+#include "bench_utils.h"
+
+namespace
+{
+    size_t constexpr NEVER = std::numeric_limits<size_t>::max();
+
+    // 2n by n limbs division with the given threshold; restores the default afterwards
+    void run_div(benchmark::State& state, size_t burnikel_ziegler, bool remainder = false)
+    {
+        magnitude::div_thresholds saved = magnitude::division_thresholds();
+        magnitude::division_thresholds().burnikel_ziegler = burnikel_ziegler;
+
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer a = bench::random_big_integer(2 * limbs, rng);
+        big_integer b = bench::random_big_integer(limbs, rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(remainder ? a % b : a / b);
+        }
+        state.SetComplexityN(state.range(0));
+        state.counters["limbs"] = benchmark::Counter(static_cast<double>(2 * limbs),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+
+        magnitude::division_thresholds() = saved;
+    }
+
+    void BM_div_knuth(benchmark::State& state)
+    {
+        run_div(state, NEVER);
+    }
+
+    void BM_div_default(benchmark::State& state)
+    {
+        run_div(state, magnitude::div_thresholds().burnikel_ziegler);
+    }
+
+    void BM_mod_default(benchmark::State& state)
+    {
+        run_div(state, magnitude::div_thresholds().burnikel_ziegler, true);
+    }
+
+    void BM_div_gmp(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer_gmp a = bench::random_gmp(2 * limbs, rng);
+        big_integer_gmp b = bench::random_gmp(limbs, rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(a / b);
+        }
+        state.SetComplexityN(state.range(0));
+        state.counters["limbs"] = benchmark::Counter(static_cast<double>(2 * limbs),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+    // n limbs by the word constant 10^9 + 7: divmod_small against the general division
+    void BM_divmod_small(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        big_integer a = bench::random_big_integer(static_cast<size_t>(state.range(0)), rng);
+        for (auto _ : state)
+        {
+            big_integer q = a;
+            benchmark::DoNotOptimize(q.divmod_small(1000000007));
+            benchmark::DoNotOptimize(q);
+        }
+        state.SetComplexityN(state.range(0));
+    }
+
+    void BM_div_small_big_integer(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        big_integer a = bench::random_big_integer(static_cast<size_t>(state.range(0)), rng);
+        big_integer b(1000000007);
+        for (auto _ : state)
+        {
+            big_integer q = a / b;
+            benchmark::DoNotOptimize(a - q * b);
+        }
+        state.SetComplexityN(state.range(0));
+    }
+
+    // quotient and remainder of 2n by n limbs, by divmod and by separate / and %
+    void BM_divmod(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer a = bench::random_big_integer(2 * limbs, rng);
+        big_integer b = bench::random_big_integer(limbs, rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(divmod(a, b));
+        }
+        state.SetComplexityN(state.range(0));
+    }
+
+    void BM_div_and_mod(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer a = bench::random_big_integer(2 * limbs, rng);
+        big_integer b = bench::random_big_integer(limbs, rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(a / b);
+            benchmark::DoNotOptimize(a % b);
+        }
+        state.SetComplexityN(state.range(0));
+    }
+
+    void huge_sizes(benchmark::internal::Benchmark* b)
+    {
+        b->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond)->Iterations(1);
+    }
+}
+
+// crossover point between Knuth's algorithm and Burnikel-Ziegler
+BENCHMARK(BM_div_knuth)->RangeMultiplier(2)->Range(8, 1 << 13)->Complexity();
+BENCHMARK(BM_div_default)->RangeMultiplier(2)->Range(8, 1 << 14)->Complexity();
+BENCHMARK(BM_mod_default)->RangeMultiplier(2)->Range(8, 1 << 14)->Complexity();
+BENCHMARK(BM_div_gmp)->RangeMultiplier(2)->Range(8, 1 << 14)->Complexity();
+
+BENCHMARK(BM_divmod_small)->RangeMultiplier(4)->Range(4, 1 << 14)->Complexity();
+BENCHMARK(BM_div_small_big_integer)->RangeMultiplier(4)->Range(4, 1 << 14)->Complexity();
+BENCHMARK(BM_divmod)->RangeMultiplier(4)->Range(8, 1 << 12)->Complexity();
+BENCHMARK(BM_div_and_mod)->RangeMultiplier(4)->Range(8, 1 << 12)->Complexity();
+
+BENCHMARK(BM_div_default)->Apply(huge_sizes);
+BENCHMARK(BM_div_gmp)->Apply(huge_sizes);
@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "../magnitude.h"
+#include "bench_utils.h"
+
+namespace
+{
+    std::vector<magnitude::limb_t> random_limbs(size_t n, std::mt19937& rng)
+    {
+        std::vector<magnitude::limb_t> result(n);
+        for (magnitude::limb_t& limb : result)
+        {
+            limb = static_cast<magnitude::limb_t>(static_cast<uint64_t>(rng()) << 32 | rng());
+        }
+        return result;
+    }
+
+    void set_limbs_rate(benchmark::State& state, size_t limbs)
+    {
+        state.counters["limbs"] = benchmark::Counter(static_cast<double>(limbs),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+    // r = op(a, b) over raw limb arrays of equal size
+    template <typename Kernel>
+    void run_kernel(benchmark::State& state, Kernel kernel)
+    {
+        std::mt19937 rng(42);
+        size_t n = static_cast<size_t>(state.range(0));
+        std::vector<magnitude::limb_t> a = random_limbs(n, rng);
+        std::vector<magnitude::limb_t> b = random_limbs(n, rng);
+        std::vector<magnitude::limb_t> r(n);
+        for (auto _ : state)
+        {
+            kernel(r.data(), a.data(), b.data(), n);
+            benchmark::DoNotOptimize(r.data());
+            benchmark::ClobberMemory();
+        }
+        set_limbs_rate(state, n);
+    }
+
+    void BM_kernel_add(benchmark::State& state)
+    {
+        run_kernel(state, [](magnitude::limb_t* r, magnitude::limb_t const* a, magnitude::limb_t const* b, size_t n) {
+            benchmark::DoNotOptimize(magnitude::add(r, a, n, b, n));
+        });
+    }
+
+    void BM_kernel_sub(benchmark::State& state)
+    {
+        run_kernel(state, [](magnitude::limb_t* r, magnitude::limb_t const* a, magnitude::limb_t const* b, size_t n) {
+            benchmark::DoNotOptimize(magnitude::sub(r, a, n, b, n));
+        });
+    }
+
+    void BM_kernel_xor(benchmark::State& state)
+    {
+        run_kernel(state, [](magnitude::limb_t* r, magnitude::limb_t const* a, magnitude::limb_t const* b, size_t n) {
+            magnitude::bitwise(r, a, b, n, [](magnitude::limb_t x, magnitude::limb_t y) { return x ^ y; });
+        });
+    }
+
+    // a op= b on big_integer values of equal length, a keeps its length; op passes over the limbs `passes` times
+    template <typename Op>
+    void run_compound(benchmark::State& state, bool a_negative, bool b_negative, Op op, size_t passes = 1)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer a = bench::random_big_integer(limbs, rng);
+        big_integer b = bench::random_big_integer(limbs, rng);
+        if (a_negative)
+        {
+            a = -a;
+        }
+        if (b_negative)
+        {
+            b = -b;
+        }
+        for (auto _ : state)
+        {
+            op(a, b);
+            benchmark::DoNotOptimize(a);
+        }
+        set_limbs_rate(state, passes * limbs);
+    }
+
+    void BM_add_assign(benchmark::State& state)
+    {
+        // alternating keeps the value bounded
+        run_compound(
+            state, false, false,
+            [](big_integer& a, big_integer const& b) {
+                a += b;
+                a -= b;
+            },
+            2);
+    }
+
+    void BM_and_assign(benchmark::State& state)
+    {
+        run_compound(state, false, false, [](big_integer& a, big_integer const& b) { a &= b; });
+    }
+
+    void BM_xor_assign(benchmark::State& state)
+    {
+        run_compound(state, false, false, [](big_integer& a, big_integer const& b) { a ^= b; });
+    }
+
+    void BM_xor_assign_negative(benchmark::State& state)
+    {
+        run_compound(state, true, false, [](big_integer& a, big_integer const& b) { a ^= b; });
+    }
+
+    void BM_or_assign_both_negative(benchmark::State& state)
+    {
+        run_compound(state, true, true, [](big_integer& a, big_integer const& b) { a |= b; });
+    }
+}
+
+BENCHMARK(BM_kernel_add)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_kernel_sub)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_kernel_xor)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+BENCHMARK(BM_add_assign)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_and_assign)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_xor_assign)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_xor_assign_negative)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_or_assign_both_negative)->RangeMultiplier(8)->Range(8, 1 << 15);
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include "../limb_memory.h"
+#include "allocation_counter.h"
+#include "bench_utils.h"
+
+namespace
+{
+    // Keeps freed buffers in free lists by size and hands them out again, as a batch evaluator might.
+    // Single-threaded, and the buffers are only released with the resource.
+    struct caching_resource : magnitude::limb_resource
+    {
+        std::map<size_t, std::vector<magnitude::limb_t*>> free;
+
+        ~caching_resource() override
+        {
+            for (auto& list : free)
+            {
+                for (magnitude::limb_t* p : list.second)
+                {
+                    magnitude::default_limb_resource()->deallocate(p, list.first);
+                }
+            }
+        }
+
+        magnitude::limb_t* allocate(size_t n) override
+        {
+            std::vector<magnitude::limb_t*>& list = free[n];
+            if (list.empty())
+            {
+                return magnitude::default_limb_resource()->allocate(n);
+            }
+            magnitude::limb_t* p = list.back();
+            list.pop_back();
+            return p;
+        }
+
+        void deallocate(magnitude::limb_t* p, size_t n) noexcept override
+        {
+            free[n].push_back(p);
+        }
+    };
+
+    // Expressions over random operands of up to state.range(0) words with mixed signs, each leaving
+    // several short-lived temporaries, like the randomized tests.
+    void run_workload(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        std::vector<big_integer> values;
+        for (size_t i = 0; i < 64; ++i)
+        {
+            big_integer x = bench::random_big_integer(1 + rng() % limbs, rng);
+            values.push_back(i % 3 == 0 ? -x : x);
+        }
+
+        size_t allocations = 0;
+        for (auto _ : state)
+        {
+            size_t before = bench::allocation_count();
+            big_integer acc;
+            for (size_t i = 0; i + 3 < values.size(); ++i)
+            {
+                big_integer const& a = values[i];
+                big_integer const& b = values[i + 1];
+                big_integer const& c = values[i + 2];
+                big_integer const& d = values[i + 3];
+                acc += (a * b + c) / d - a % d;
+                acc %= a * c;
+            }
+            allocations += bench::allocation_count() - before;
+            benchmark::DoNotOptimize(acc);
+        }
+        state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocations),
+                                                      benchmark::Counter::kAvgIterations);
+    }
+
+    void BM_workload(benchmark::State& state)
+    {
+        run_workload(state);
+    }
+
+    void BM_workload_caching_resource(benchmark::State& state)
+    {
+        caching_resource resource;
+        {
+            magnitude::scoped_limb_resource scope(&resource);
+            run_workload(state);
+        }
+    }
+}
+
+// allocations and time per round of the workload; kernel temporaries come from the scratch arena
+BENCHMARK(BM_workload)->RangeMultiplier(8)->Range(4, 1 << 12);
+BENCHMARK(BM_workload_caching_resource)->RangeMultiplier(8)->Range(4, 1 << 12);
@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+
+#include "../modular.h"
+#include "bench_utils.h"
+
+namespace
+{
+    // RSA-like sizes: an odd modulus of n words, a full-size base and exponent
+    struct modular_operands
+    {
+        big_integer modulus;
+        big_integer base;
+        big_integer exponent;
+    };
+
+    modular_operands random_operands(size_t limbs)
+    {
+        std::mt19937 rng(42);
+        modular_operands result;
+        result.modulus = bench::random_big_integer(limbs, rng) | 1;
+        result.base = bench::random_big_integer(limbs, rng) % result.modulus;
+        result.exponent = bench::random_big_integer(limbs, rng);
+        return result;
+    }
+
+    void BM_pow_mod(benchmark::State& state)
+    {
+        modular_operands x = random_operands(static_cast<size_t>(state.range(0)));
+        modular_context context(x.modulus);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(context.pow_mod(x.base, x.exponent));
+        }
+        state.counters["bits"] = static_cast<double>(state.range(0) * bench::LIMB_BITS);
+    }
+
+    // square-and-multiply through *= and %=
+    void BM_pow_mod_naive(benchmark::State& state)
+    {
+        modular_operands x = random_operands(static_cast<size_t>(state.range(0)));
+        size_t bits = static_cast<size_t>(state.range(0)) * bench::LIMB_BITS;
+        for (auto _ : state)
+        {
+            big_integer result = 1;
+            for (size_t i = bits; i != 0;)
+            {
+                --i;
+                result *= result;
+                result %= x.modulus;
+                if (((x.exponent >> static_cast<int>(i)) & 1) != 0)
+                {
+                    result *= x.base;
+                    result %= x.modulus;
+                }
+            }
+            benchmark::DoNotOptimize(result);
+        }
+        state.counters["bits"] = static_cast<double>(bits);
+    }
+
+    void BM_pow_mod_gmp(benchmark::State& state)
+    {
+        modular_operands x = random_operands(static_cast<size_t>(state.range(0)));
+        big_integer_gmp modulus(to_string(x.modulus));
+        big_integer_gmp base(to_string(x.base));
+        big_integer_gmp exponent(to_string(x.exponent));
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(pow_mod(base, exponent, modulus));
+        }
+        state.counters["bits"] = static_cast<double>(state.range(0) * bench::LIMB_BITS);
+    }
+
+    void BM_mul_mod(benchmark::State& state)
+    {
+        modular_operands x = random_operands(static_cast<size_t>(state.range(0)));
+        modular_context context(x.modulus);
+        big_integer y = x.exponent % x.modulus;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(context.mul_mod(x.base, y));
+        }
+    }
+
+    void BM_mul_mod_naive(benchmark::State& state)
+    {
+        modular_operands x = random_operands(static_cast<size_t>(state.range(0)));
+        big_integer y = x.exponent % x.modulus;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(x.base * y % x.modulus);
+        }
+    }
+
+    // 1024, 2048 and 4096-bit moduli
+    void rsa_sizes(benchmark::internal::Benchmark* b)
+    {
+        b->Arg(32)->Arg(64)->Arg(128)->Unit(benchmark::kMicrosecond);
+    }
+}
+
+BENCHMARK(BM_pow_mod)->Apply(rsa_sizes);
+BENCHMARK(BM_pow_mod_naive)->Apply(rsa_sizes);
+BENCHMARK(BM_pow_mod_gmp)->Apply(rsa_sizes);
+BENCHMARK(BM_mul_mod)->Apply(rsa_sizes);
+BENCHMARK(BM_mul_mod_naive)->Apply(rsa_sizes);
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <limits>
+
+#include "../magnitude.h"
+#include "bench_utils.h"
+
+namespace
+{
+    size_t constexpr NEVER = std::numeric_limits<size_t>::max();
+
+    // Runs a * b (or a * a) with the given thresholds; restores the defaults afterwards.
+    void run_mul(benchmark::State& state, magnitude::mul_thresholds const& config, bool square = false)
+    {
+        magnitude::mul_thresholds saved = magnitude::thresholds();
+        magnitude::thresholds() = config;
+
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer a = bench::random_big_integer(limbs, rng);
+        big_integer b = bench::random_big_integer(limbs, rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(square ? ::square(a) : a * b);
+        }
+        state.SetComplexityN(state.range(0));
+        state.counters["limbs"] = benchmark::Counter(static_cast<double>(2 * limbs),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+
+        magnitude::thresholds() = saved;
+    }
+
+    void BM_mul_schoolbook(benchmark::State& state)
+    {
+        run_mul(state, {NEVER, NEVER, NEVER});
+    }
+
+    void BM_mul_karatsuba(benchmark::State& state)
+    {
+        run_mul(state, {magnitude::mul_thresholds().karatsuba, NEVER, NEVER});
+    }
+
+    void BM_mul_toom3(benchmark::State& state)
+    {
+        size_t karatsuba = magnitude::mul_thresholds().karatsuba;
+        run_mul(state, {karatsuba, karatsuba, NEVER});
+    }
+
+    void BM_mul_ntt(benchmark::State& state)
+    {
+        size_t karatsuba = magnitude::mul_thresholds().karatsuba;
+        run_mul(state, {karatsuba, NEVER, karatsuba});
+    }
+
+    void BM_mul_default(benchmark::State& state)
+    {
+        run_mul(state, magnitude::mul_thresholds());
+    }
+
+    void BM_sqr_default(benchmark::State& state)
+    {
+        run_mul(state, magnitude::mul_thresholds(), true);
+    }
+
+    void BM_mul_gmp(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer_gmp a = bench::random_gmp(limbs, rng);
+        big_integer_gmp b = bench::random_gmp(limbs, rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(a * b);
+        }
+        state.SetComplexityN(state.range(0));
+        state.counters["limbs"] = benchmark::Counter(static_cast<double>(2 * limbs),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+    void huge_sizes(benchmark::internal::Benchmark* b)
+    {
+        b->Arg(100000)->Arg(1000000)->Arg(10000000)->Unit(benchmark::kMillisecond)->Iterations(1);
+    }
+}
+
+// crossover points between the algorithms
+BENCHMARK(BM_mul_schoolbook)->RangeMultiplier(2)->Range(8, 1 << 13)->Complexity();
+BENCHMARK(BM_mul_karatsuba)->RangeMultiplier(2)->Range(8, 1 << 14)->Complexity();
+BENCHMARK(BM_mul_toom3)->RangeMultiplier(2)->Range(8, 1 << 14)->Complexity();
+BENCHMARK(BM_mul_ntt)->RangeMultiplier(2)->Range(8, 1 << 14)->Complexity();
+BENCHMARK(BM_mul_default)->RangeMultiplier(2)->Range(8, 1 << 14)->Complexity();
+BENCHMARK(BM_mul_gmp)->RangeMultiplier(2)->Range(8, 1 << 14)->Complexity();
+
+// throughput on huge operands
+BENCHMARK(BM_mul_default)->Apply(huge_sizes);
+BENCHMARK(BM_sqr_default)->Apply(huge_sizes);
+BENCHMARK(BM_mul_gmp)->Apply(huge_sizes);
@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <limits>
+
+#include "../magnitude.h"
+#include "bench_utils.h"
+
+namespace
+{
+    size_t constexpr NEVER = std::numeric_limits<size_t>::max();
+
+    // gcd of two n-limb numbers with the given half-gcd threshold; restores the default afterwards
+    void run_gcd(benchmark::State& state, size_t half_gcd)
+    {
+        magnitude::div_thresholds saved = magnitude::division_thresholds();
+        magnitude::division_thresholds().half_gcd = half_gcd;
+
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer a = bench::random_big_integer(limbs, rng);
+        big_integer b = bench::random_big_integer(limbs, rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(gcd(a, b));
+        }
+        state.SetComplexityN(state.range(0));
+
+        magnitude::division_thresholds() = saved;
+    }
+
+    void BM_gcd_lehmer(benchmark::State& state)
+    {
+        run_gcd(state, NEVER);
+    }
+
+    void BM_gcd(benchmark::State& state)
+    {
+        run_gcd(state, magnitude::div_thresholds().half_gcd);
+    }
+
+    void BM_gcd_gmp(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer_gmp a = bench::random_gmp(limbs, rng);
+        big_integer_gmp b = bench::random_gmp(limbs, rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(gcd(a, b));
+        }
+        state.SetComplexityN(state.range(0));
+    }
+
+    void BM_extended_gcd(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer a = bench::random_big_integer(limbs, rng);
+        big_integer b = bench::random_big_integer(limbs, rng);
+        big_integer x, y;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(extended_gcd(a, b, x, y));
+        }
+        state.SetComplexityN(state.range(0));
+    }
+
+    void BM_extended_gcd_gmp(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer_gmp a = bench::random_gmp(limbs, rng);
+        big_integer_gmp b = bench::random_gmp(limbs, rng);
+        big_integer_gmp x, y;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(extended_gcd(a, b, x, y));
+        }
+        state.SetComplexityN(state.range(0));
+    }
+
+    // square and cube roots of a 2n-limb number
+    void BM_isqrt(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        big_integer a = bench::random_big_integer(2 * static_cast<size_t>(state.range(0)), rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(isqrt(a));
+        }
+        state.SetComplexityN(state.range(0));
+    }
+
+    void BM_isqrt_gmp(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        big_integer_gmp a = bench::random_gmp(2 * static_cast<size_t>(state.range(0)), rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(isqrt(a));
+        }
+        state.SetComplexityN(state.range(0));
+    }
+
+    void BM_iroot(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        big_integer a = bench::random_big_integer(2 * static_cast<size_t>(state.range(0)), rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(iroot(a, 3));
+        }
+        state.SetComplexityN(state.range(0));
+    }
+
+    void BM_iroot_gmp(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        big_integer_gmp a = bench::random_gmp(2 * static_cast<size_t>(state.range(0)), rng);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(iroot(a, 3));
+        }
+        state.SetComplexityN(state.range(0));
+    }
+}
+
+// crossover point between Lehmer's algorithm and the half-gcd recursion
+BENCHMARK(BM_gcd_lehmer)->RangeMultiplier(4)->Range(4, 1 << 12)->Complexity();
+BENCHMARK(BM_gcd)->RangeMultiplier(4)->Range(4, 1 << 14)->Complexity();
+BENCHMARK(BM_gcd_gmp)->RangeMultiplier(4)->Range(4, 1 << 14)->Complexity();
+BENCHMARK(BM_extended_gcd)->RangeMultiplier(4)->Range(4, 1 << 14)->Complexity();
+BENCHMARK(BM_extended_gcd_gmp)->RangeMultiplier(4)->Range(4, 1 << 14)->Complexity();
+
+BENCHMARK(BM_isqrt)->RangeMultiplier(4)->Range(4, 1 << 14)->Complexity();
+BENCHMARK(BM_isqrt_gmp)->RangeMultiplier(4)->Range(4, 1 << 14)->Complexity();
+BENCHMARK(BM_iroot)->RangeMultiplier(4)->Range(4, 1 << 14)->Complexity();
+BENCHMARK(BM_iroot_gmp)->RangeMultiplier(4)->Range(4, 1 << 14)->Complexity();
@@ -0,0 +1,245 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "allocation_counter.h"
+#include "bench_utils.h"
+
+// Every operator of big_integer and of the GMP reference on the same operands, from 1 to 2^20 words.
+// Names are ops/<operator>/<signs>/<ours|gmp>/<words>, which benchmarks/report.py pairs up to show the ratio
+// to GMP and to compare a run with an earlier one.
+namespace
+{
+    enum class signs
+    {
+        positive,
+        mixed,
+        negative
+    };
+
+    char const* sign_name(signs s)
+    {
+        return s == signs::positive ? "positive" : s == signs::mixed ? "mixed" : "negative";
+    }
+
+    big_integer_gmp to_gmp(big_integer const& a)
+    {
+        std::vector<unsigned char> bytes = to_bytes(a, byte_order::big_endian);
+        big_integer_gmp result = big_integer_gmp::from_bytes(bytes.data(), bytes.size());
+        return a < 0 ? -result : result;
+    }
+
+    // a of `words` words and b of b_words, negative as the signs say
+    template <typename T>
+    struct operands;
+
+    template <>
+    struct operands<big_integer>
+    {
+        static void make(big_integer& a, big_integer& b, size_t words, size_t b_words, signs s)
+        {
+            std::mt19937 rng(42);
+            a = bench::random_big_integer(words, rng);
+            b = bench::random_big_integer(b_words, rng);
+            if (s != signs::positive)
+            {
+                a = -a;
+            }
+            if (s == signs::negative)
+            {
+                b = -b;
+            }
+        }
+    };
+
+    template <>
+    struct operands<big_integer_gmp>
+    {
+        static void make(big_integer_gmp& a, big_integer_gmp& b, size_t words, size_t b_words, signs s)
+        {
+            big_integer x;
+            big_integer y;
+            operands<big_integer>::make(x, y, words, b_words, s);
+            a = to_gmp(x);
+            b = to_gmp(y);
+        }
+    };
+
+    enum class operation
+    {
+        add,
+        sub,
+        mul,
+        div,
+        mod,
+        bit_and,
+        bit_or,
+        bit_xor,
+        less,
+        equal,
+        negate,
+        bit_not,
+        shl,
+        shr,
+        increment,
+        to_string,
+        from_string
+    };
+
+    struct operation_info
+    {
+        operation op;
+        char const* name;
+        // the second operand has words / b_divisor words
+        size_t b_divisor;
+        // arithmetic operators run on nonnegative and on mixed operands, bitwise ones also on two negative
+        // operands; the others on a negative and a positive one
+        bool binary;
+        bool bitwise;
+    };
+
+    operation_info const OPERATIONS[] = {
+        {operation::add, "add", 1, true, false},
+        {operation::sub, "sub", 1, true, false},
+        {operation::mul, "mul", 1, true, false},
+        {operation::div, "div", 2, true, false},
+        {operation::mod, "mod", 2, true, false},
+        {operation::bit_and, "and", 1, true, true},
+        {operation::bit_or, "or", 1, true, true},
+        {operation::bit_xor, "xor", 1, true, true},
+        {operation::less, "less", 1, false, false},
+        {operation::equal, "equal", 1, false, false},
+        {operation::negate, "negate", 1, false, false},
+        {operation::bit_not, "not", 1, false, false},
+        {operation::shl, "shl", 1, false, false},
+        {operation::shr, "shr", 1, false, false},
+        {operation::increment, "increment", 1, false, false},
+        {operation::to_string, "to_string", 1, false, false},
+        {operation::from_string, "from_string", 1, false, false},
+    };
+
+    // x is the mutable copy of a for the in-place operations, str its decimal form
+    template <typename T>
+    void apply(operation op, T const& a, T const& b, T& x, std::string const& str)
+    {
+        switch (op)
+        {
+        case operation::add:
+            benchmark::DoNotOptimize(a + b);
+            break;
+        case operation::sub:
+            benchmark::DoNotOptimize(a - b);
+            break;
+        case operation::mul:
+            benchmark::DoNotOptimize(a * b);
+            break;
+        case operation::div:
+            benchmark::DoNotOptimize(a / b);
+            break;
+        case operation::mod:
+            benchmark::DoNotOptimize(a % b);
+            break;
+        case operation::bit_and:
+            benchmark::DoNotOptimize(a & b);
+            break;
+        case operation::bit_or:
+            benchmark::DoNotOptimize(a | b);
+            break;
+        case operation::bit_xor:
+            benchmark::DoNotOptimize(a ^ b);
+            break;
+        case operation::less:
+            benchmark::DoNotOptimize(a < b);
+            break;
+        case operation::equal:
+            benchmark::DoNotOptimize(a == b);
+            break;
+        case operation::negate:
+            benchmark::DoNotOptimize(-a);
+            break;
+        case operation::bit_not:
+            benchmark::DoNotOptimize(~a);
+            break;
+        case operation::shl:
+            benchmark::DoNotOptimize(a << 1000);
+            break;
+        case operation::shr:
+            benchmark::DoNotOptimize(a >> 1000);
+            break;
+        case operation::increment:
+            benchmark::DoNotOptimize(++x);
+            break;
+        case operation::to_string:
+            benchmark::DoNotOptimize(to_string(a));
+            break;
+        case operation::from_string:
+            benchmark::DoNotOptimize(T(str));
+            break;
+        }
+    }
+
+    template <typename T>
+    void run(benchmark::State& state, operation_info info, signs s)
+    {
+        size_t words = static_cast<size_t>(state.range(0));
+        T a;
+        T b;
+        operands<T>::make(a, b, words, std::max<size_t>(words / info.b_divisor, 1), s);
+        // equal operands are compared to the last limb
+        if (info.op == operation::equal)
+        {
+            b = a;
+        }
+        T x = a;
+        std::string str = info.op == operation::from_string ? to_string(a) : std::string();
+
+        size_t allocations = 0;
+        for (auto _ : state)
+        {
+            size_t before = bench::allocation_count();
+            apply(info.op, a, b, x, str);
+            allocations += bench::allocation_count() - before;
+        }
+        state.SetComplexityN(state.range(0));
+        // GMP allocates through malloc, which the counter does not see
+        state.counters["allocs"] =
+            benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+    }
+
+    template <typename T>
+    void register_implementation(std::string const& name, operation_info info, signs s)
+    {
+        auto f = [info, s](benchmark::State& state) { run<T>(state, info, s); };
+        // 1, 8, ..., 2^18 words, then about 10^6 words once
+        for (size_t words = 1; words <= (size_t(1) << 18); words *= 8)
+        {
+            benchmark::RegisterBenchmark(name.c_str(), f)->Arg(static_cast<int64_t>(words));
+        }
+        benchmark::RegisterBenchmark(name.c_str(), f)
+            ->Arg(int64_t(1) << 20)
+            ->Iterations(1)
+            ->Unit(benchmark::kMillisecond);
+    }
+
+    int register_operations()
+    {
+        for (operation_info const& info : OPERATIONS)
+        {
+            for (signs s : {signs::positive, signs::mixed, signs::negative})
+            {
+                bool wanted = info.binary ? s != signs::negative || info.bitwise : s == signs::mixed;
+                if (!wanted)
+                {
+                    continue;
+                }
+                std::string name = std::string("ops/") + info.name + "/" + sign_name(s);
+                register_implementation<big_integer>(name + "/ours", info, s);
+                register_implementation<big_integer_gmp>(name + "/gmp", info, s);
+            }
+        }
+        return 0;
+    }
+
+    int const registered = register_operations();
+}
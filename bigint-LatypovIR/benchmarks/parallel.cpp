@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include "../magnitude.h"
+#include "bench_utils.h"
+
+namespace
+{
+    // state.range(1) threads for the duration of a benchmark
+    struct thread_count
+    {
+        explicit thread_count(benchmark::State& state) : saved(magnitude::parallel_execution())
+        {
+            magnitude::parallel_execution().threads = static_cast<size_t>(state.range(1));
+        }
+
+        ~thread_count()
+        {
+            magnitude::parallel_execution() = saved;
+        }
+
+        magnitude::parallel_settings saved;
+    };
+
+    void BM_mul_threads(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        size_t limbs = static_cast<size_t>(state.range(0));
+        big_integer a = bench::random_big_integer(limbs, rng);
+        big_integer b = bench::random_big_integer(limbs, rng);
+        thread_count threads(state);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(a * b);
+        }
+    }
+
+    void BM_to_string_threads(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        big_integer a = bench::random_big_integer(static_cast<size_t>(state.range(0)), rng);
+        thread_count threads(state);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(to_string(a));
+        }
+    }
+
+    void BM_from_string_threads(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        std::string s = to_string(bench::random_big_integer(static_cast<size_t>(state.range(0)), rng));
+        thread_count threads(state);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(big_integer(s));
+        }
+    }
+
+    // wall time, since the work is spread over threads
+    void thread_scaling(benchmark::internal::Benchmark* b, int limbs)
+    {
+        for (int threads : {1, 2, 4, 8, 16})
+        {
+            b->Args({limbs, threads});
+        }
+        b->ArgNames({"limbs", "threads"})->UseRealTime()->Unit(benchmark::kMillisecond)->Iterations(1);
+    }
+
+    void mul_sizes(benchmark::internal::Benchmark* b)
+    {
+        thread_scaling(b, 1000000);
+    }
+
+    void conversion_sizes(benchmark::internal::Benchmark* b)
+    {
+        thread_scaling(b, 100000);
+    }
+}
+
+BENCHMARK(BM_mul_threads)->Apply(mul_sizes);
+BENCHMARK(BM_to_string_threads)->Apply(conversion_sizes);
+BENCHMARK(BM_from_string_threads)->Apply(conversion_sizes);
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Summary of a JSON run of bench (--benchmark_out=<file> --benchmark_out_format=json).
+
+Prints the ops/... suite as a table of big_integer against GMP. With --baseline, compares the run with an earlier
+one and exits with 1 if a benchmark got slower by more than --threshold. Where both runs have the GMP
+counterpart, the ratio to GMP is compared instead of the time, which cancels out the speed of the machine.
+"""
+
+import argparse
+import csv
+import json
+import sys
+
+UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path):
+    """name -> (time in ns, allocations per iteration or None) of the runs in a JSON file"""
+    with open(path) as f:
+        data = json.load(f)
+    results = {}
+    for b in data["benchmarks"]:
+        if b.get("run_type", "iteration") != "iteration":
+            continue
+        results[b["name"]] = (b["real_time"] * UNITS[b.get("time_unit", "ns")], b.get("allocs"))
+    return results
+
+
+def gmp_name(name):
+    """the GMP counterpart of ops/<op>/<signs>/ours/<words>[/iterations:1], or None"""
+    parts = name.split("/")
+    if len(parts) >= 5 and parts[0] == "ops" and parts[3] == "ours":
+        parts[3] = "gmp"
+        return "/".join(parts)
+    return None
+
+
+def format_time(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return "%.3g %s" % (ns / scale, unit)
+    return "%.3g ns" % ns
+
+
+def table(results):
+    rows = []
+    for name, (time, allocs) in results.items():
+        reference = gmp_name(name)
+        if reference is None or reference not in results:
+            continue
+        _, op, signs, _, words = name.split("/")[:5]
+        gmp_time = results[reference][0]
+        rows.append((op, signs, int(words), time, gmp_time, time / gmp_time, allocs))
+    return rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("results", help="JSON output of bench")
+    parser.add_argument("--baseline", help="JSON output of an earlier run to compare with")
+    parser.add_argument("--threshold", type=float, default=0.1,
+                        help="relative slowdown reported as a regression (default 0.1)")
+    parser.add_argument("--csv", help="also write the table to this CSV file")
+    args = parser.parse_args()
+
+    results = load(args.results)
+    rows = table(results)
+    if rows:
+        print("%-12s %-9s %8s %12s %12s %8s %8s" % ("operator", "signs", "words", "ours", "gmp", "ratio", "allocs"))
+        for op, signs, words, time, gmp_time, ratio, allocs in rows:
+            print("%-12s %-9s %8d %12s %12s %8.2f %8s" % (op, signs, words, format_time(time), format_time(gmp_time),
+                                                          ratio, "" if allocs is None else "%.3g" % allocs))
+    if args.csv:
+        with open(args.csv, "w", newline="") as f:
+            writer = csv.writer(f)
+            writer.writerow(["operator", "signs", "words", "ours_ns", "gmp_ns", "ratio", "allocs"])
+            writer.writerows(rows)
+
+    if not args.baseline:
+        return 0
+    baseline = load(args.baseline)
+    regressions = []
+    for name, (time, _) in results.items():
+        if name not in baseline or name.split("/")[3:4] == ["gmp"]:
+            continue
+        reference = gmp_name(name)
+        if reference is not None and reference in results and reference in baseline:
+            before = baseline[name][0] / baseline[reference][0]
+            after = time / results[reference][0]
+            metric = "ratio to gmp"
+        else:
+            before = baseline[name][0]
+            after = time
+            metric = "time"
+        change = after / before - 1
+        if change > args.threshold:
+            regressions.append((change, name, metric, before, after))
+
+    print()
+    if not regressions:
+        print("no regressions over %.0f%% against %s" % (100 * args.threshold, args.baseline))
+        return 0
+    print("regressions over %.0f%% against %s:" % (100 * args.threshold, args.baseline))
+    for change, name, metric, before, after in sorted(regressions, reverse=True):
+        shown = (lambda x: "%.3g" % x) if metric != "time" else format_time
+        print("  %-50s %s %s -> %s (+%.0f%%)" % (name, metric, shown(before), shown(after), 100 * change))
+    return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,5 +1,7 @@
 #include "big_integer.h"
+#include "magnitude.h"
 
+#include <bitset>
 #include <cstddef>
 #include <cstring>
 #include <ostream>
@@ -8,13 +10,18 @@
 #include <vector>
 #include <algorithm>
 
-uint32_t constexpr BASE = 10;
-uint8_t constexpr BITS = 32;
+using magnitude::LIMB_BITS;
+using magnitude::LIMB_MAX;
 
-big_integer::big_integer(): negate_(false), data_(1, 0) {}
+big_integer::big_integer(): negate_(false) {}
 
 big_integer::big_integer(big_integer const& other) = default;
 
+// the moved-from object is left zero
+big_integer::big_integer(big_integer&& other) noexcept : negate_(other.negate_), data_(std::move(other.data_)) {
+    other.negate_ = false;
+}
+
 big_integer::big_integer(int a) : big_integer(static_cast<long long>(a)) {}
 
 big_integer::big_integer(unsigned int a) : big_integer(static_cast<unsigned long long>(a)) {}
@@ -23,113 +30,127 @@ big_integer::big_integer(long a) : big_integer(static_cast<long long>(a)) {}
 
 big_integer::big_integer(unsigned long a) : big_integer(static_cast<unsigned long long>(a)) {}
 
-big_integer::big_integer(long long a) : big_integer(static_cast<unsigned long long>(a)) {
+big_integer::big_integer(long long a)
+    : big_integer(a < 0 ? 0ULL - static_cast<unsigned long long>(a) : static_cast<unsigned long long>(a)) {
     negate_ = a < 0;
-    normalize();
 }
 
 big_integer::big_integer(unsigned long long a) : negate_(false) {
-    do {
-        data_.push_back(static_cast<unsigned int>(a));
-    } while ( (a >>= BITS) != 0);
-    normalize();
+    set_magnitude(a);
 }
 
-big_integer::big_integer(std::string const& str) : big_integer() {
-
-    if (str.empty()) {
-        throw std::invalid_argument(str);
-    }
+big_integer::~big_integer() = default;
 
-    size_t start = (str[0] == '-' || str[0] == '+') ? 1 : 0;
-    if (start == str.length()) {
-        throw std::invalid_argument(str);
-    }
-    for (size_t i = start; i < str.length(); i++) {
-        if (str[i] < '0' || str[i] > '9') {
-            throw std::invalid_argument(str);
-        }
-    }
+big_integer& big_integer::operator=(big_integer const& other) = default;
 
-    for (size_t i = start; i != str.length(); ++i) {
-        (*this) *= BASE;
-        (*this) += str[i] - '0';
-    }
-    if (str[0] == '-') {
-        *this = -*this;
+big_integer& big_integer::operator=(big_integer&& other) noexcept {
+    if (this != &other) {
+        negate_ = other.negate_;
+        data_ = std::move(other.data_);
+        other.negate_ = false;
     }
+    return *this;
 }
 
-big_integer::~big_integer() = default;
-
-big_integer& big_integer::operator=(big_integer const& other) = default;
-
 big_integer& big_integer::operator+=(big_integer const& rhs)
 {
-    add_subtract([](auto a, auto b) { return a + b; }, rhs);
+    add_subtract(rhs, false);
     return *this;
 }
 
 big_integer& big_integer::operator-=(big_integer const& rhs)
 {
-    add_subtract([](auto a, auto b) { return a - b; }, rhs);
+    add_subtract(rhs, true);
     return *this;
 }
 
 big_integer& big_integer::operator*=(big_integer const& rhs) {
-
-    if (rhs.negate_) {
-        *this = -*this;
-        return *this *= -rhs;
+    if (is_zero() || rhs.is_zero()) {
+        data_.clear();
+        negate_ = false;
+        return *this;
     }
 
-    bool sign = negate_;
-    if (negate_) {
-        *this = -*this;
+    negate_ = negate_ != rhs.negate_;
+    if (data_.size() == 1 && rhs.data_.size() == 1) {
+        set_magnitude(static_cast<double_limb_t>(data_[0]) * rhs.data_[0]);
+        return *this;
     }
 
-    std::vector<uint32_t> c(data_.size() + rhs.data_.size() + 1, negate_ ? UINT32_MAX : 0);
-    uint64_t carry = 0;
-    for (size_t i = 0; i < data_.size(); ++i) {
-        for (size_t j = 0; j <= rhs.data_.size(); ++j) {
-            c[i + j] = carry = static_cast<uint64_t>(data_[i]) * take_n(j, rhs) + carry + c[i + j];
-            carry >>= BITS;
-        }
+    // x *= x passes one array, which makes magnitude::mul square; equal values in
+    // different objects are not compared, square() is there for them
+    limb_t const* rhs_data = &rhs == this ? data_.data() : rhs.data_.data();
+    size_t size = data_.size() + rhs.data_.size();
+    if (size <= data_.capacity()) {
+        // the current buffer holds the product: it goes through scratch memory instead of a new buffer
+        magnitude::scratch_frame frame;
+        magnitude::scratch_buffer c(size);
+        magnitude::mul(c.data(), data_.data(), data_.size(), rhs_data, rhs.data_.size());
+        data_.resize(size);
+        std::copy(c.begin(), c.end(), data_.begin());
+    } else {
+        storage c(size);
+        magnitude::mul(c.data(), data_.data(), data_.size(), rhs_data, rhs.data_.size());
+        std::swap(data_, c);
     }
-    std::swap(data_, c);
     normalize();
-
-    if (sign) {
-        *this = -*this;
-    }
     return *this;
 }
 
 big_integer& big_integer::operator/=(big_integer const& rhs) {
+    bool sign = negate_ != rhs.negate_;
+    divide(rhs, false);
+    negate_ = sign;
+    normalize();
+    return *this;
+}
 
-    if (rhs.negate_) {
-        *this = -*this;
-        return *this /= -rhs;
-    }
-
+long long big_integer::divmod_small(uint32_t divisor) {
     bool sign = negate_;
-    if (negate_) {
-        *this = -*this;
-    }
-
-    divide(rhs);
+    // one hardware division for the reciprocal, then a multiplication per limb
+    limb_t r = magnitude::divmod_1(data_.data(), data_.data(), data_.size(), magnitude::limb_divisor(divisor));
+    normalize();
+    return sign ? -static_cast<long long>(r) : static_cast<long long>(r);
+}
 
+big_integer& big_integer::operator%=(big_integer const& rhs) {
+    // the remainder takes the sign of the dividend
+    bool sign = negate_;
+    divide(rhs, true);
+    negate_ = sign;
     normalize();
+    return *this;
+}
+
+// Bitwise operations act on infinite two's complement: negative operands are converted over
+// max(size) + 1 limbs, above which every limb equals the sign fill.
+template <typename Op>
+void big_integer::bit_operator(Op op, big_integer const& rhs) {
+    bool result_negate = op(negate_ ? LIMB_MAX : 0, rhs.negate_ ? LIMB_MAX : 0) != 0;
+    size_t size = std::max(data_.size(), rhs.data_.size()) + 1;
+    size_t rhs_size = rhs.data_.size();
 
-    if (sign) {
-        *this = -*this;
+    // a negative rhs is copied before *this (which rhs may be) is modified
+    storage rhs_complement;
+    if (rhs.negate_) {
+        rhs_complement.resize(rhs_size);
+        magnitude::neg(rhs_complement.data(), rhs.data_.data(), rhs_size);
     }
 
-    return *this;
-}
+    data_.resize(size);
+    if (negate_) {
+        magnitude::neg(data_.data(), data_.data(), size);
+    }
+    limb_t const* b = rhs.negate_ ? rhs_complement.data() : rhs.data_.data();
+    magnitude::bitwise(data_.data(), data_.data(), b, rhs_size, op);
+    magnitude::bitwise_1(data_.data() + rhs_size, data_.data() + rhs_size, size - rhs_size,
+                         rhs.negate_ ? LIMB_MAX : 0, op);
 
-big_integer& big_integer::operator%=(big_integer const& rhs) {
-    return *this -= ((*this) / rhs) * rhs;
+    if (result_negate) {
+        magnitude::neg(data_.data(), data_.data(), size);
+    }
+    negate_ = result_negate;
+    normalize();
 }
 
 big_integer& big_integer::operator&=(big_integer const& rhs) {
@@ -148,43 +169,112 @@ big_integer& big_integer::operator^=(big_integer const& rhs) {
 }
 
 big_integer& big_integer::operator<<=(int rhs) {
-    size_t add = rhs / BITS;
-    rhs %= BITS;
-    data_.resize(data_.size() + add + 1, negate_ ? UINT32_MAX : 0);
-    for (size_t i = data_.size(); i > 0; ) {
-        --i;
-        if (i < add) {
-            data_[i] = 0;
-        } else data_[i] = (data_[i - add] << rhs) | ((i == add) ? 0 : (data_[i - add - 1] >> (BITS - rhs)));
+    if (is_zero()) {
+        return *this;
     }
-    normalize();
+    size_t offset = rhs / LIMB_BITS;
+    unsigned shift = rhs % LIMB_BITS;
+    size_t size = data_.size();
+    // the magnitude is shifted in place, one more limb only if the top one overflows
+    bool overflow = shift != 0 && data_.back() >> (LIMB_BITS - shift) != 0;
+    data_.resize(size + offset + (overflow ? 1 : 0));
+    limb_t* p = data_.data();
+    if (shift == 0) {
+        std::memmove(p + offset, p, size * sizeof(limb_t));
+    } else {
+        limb_t out = magnitude::lshift(p + offset, p, size, shift);
+        if (overflow) {
+            p[size + offset] = out;
+        }
+    }
+    std::fill(p, p + offset, 0);
     return *this;
 }
 
 big_integer& big_integer::operator>>=(int rhs) {
-    data_.erase(data_.begin(), data_.begin() + rhs / BITS);
-    rhs %= BITS;
-    for (size_t i = 0; i < data_.size(); i++)
-    {
-        data_[i] = (data_[i] >> rhs) |
-                   ((i + 1 == data_.size() ? (negate_ ? ((1U << rhs) - 1) : 0U) : (data_[i + 1])) << (BITS - rhs));
-    }
-    resize(data_.size() + 1);
+    size_t size = data_.size();
+    size_t offset = std::min(size, static_cast<size_t>(rhs / LIMB_BITS));
+    unsigned shift = rhs % LIMB_BITS;
+    limb_t* p = data_.data();
+    // shifting is a floor division: a negative value gains one in magnitude if set bits are shifted out
+    bool round_away = negate_ && std::any_of(p, p + offset, [](limb_t x) { return x != 0; });
+    if (shift == 0 || offset == size) {
+        std::memmove(p, p + offset, (size - offset) * sizeof(limb_t));
+    } else {
+        limb_t out = magnitude::rshift(p, p + offset, size - offset, shift);
+        round_away |= negate_ && out != 0;
+    }
+    bool sign = negate_;
+    data_.resize(size - offset);
     normalize();
+    if (round_away) {
+        negate_ = sign;
+        add_subtract(1, true);
+    }
     return *this;
 }
 
+size_t big_integer::bit_length() const {
+    if (is_zero()) {
+        return 0;
+    }
+    size_t result = (data_.size() - 1) * LIMB_BITS;
+    for (limb_t top = data_.back(); top != 0; top >>= 1) {
+        ++result;
+    }
+    return result;
+}
+
+size_t big_integer::popcount() const {
+    size_t result = 0;
+    for (limb_t x : data_) {
+        result += std::bitset<LIMB_BITS>(x).count();
+    }
+    return result;
+}
+
+bool big_integer::test_bit(size_t index) const {
+    size_t limb = index / LIMB_BITS;
+    if (limb >= data_.size()) {
+        return negate_;
+    }
+    limb_t x = data_[limb];
+    if (negate_) {
+        // two's complement: zero limbs below the lowest set bit stay zero, that limb is negated, higher ones inverted
+        bool lower_zero = std::all_of(data_.begin(), data_.begin() + limb, [](limb_t y) { return y == 0; });
+        x = lower_zero ? 0 - x : ~x;
+    }
+    return (x >> (index % LIMB_BITS) & 1) != 0;
+}
+
+void big_integer::set_bit(size_t index, bool value) {
+    if (test_bit(index) == value) {
+        return;
+    }
+    // the value changes by +-2^index; a negative value moves towards zero when a bit is set and never crosses it
+    limb_t bit = limb_t(1) << (index % LIMB_BITS);
+    size_t limb = index / LIMB_BITS;
+    if (negate_ == value) {
+        magnitude::sub(data_.data() + limb, data_.data() + limb, data_.size() - limb, &bit, 1);
+        normalize();
+    } else {
+        if (data_.size() <= limb) {
+            data_.resize(limb + 1);
+        }
+        if (magnitude::add(data_.data() + limb, data_.data() + limb, data_.size() - limb, &bit, 1) != 0) {
+            data_.push_back(1);
+        }
+    }
+}
+
 big_integer big_integer::operator+() const {
     return *this;
 }
 
 big_integer big_integer::operator-() const {
     big_integer tmp((*this));
-    for (uint32_t& x : tmp.data_) {
-        x = ~x;
-    }
-    tmp.negate_ = !tmp.negate_;
-    return ++tmp;
+    tmp.flip_sign();
+    return tmp;
 }
 
 big_integer big_integer::operator~() const {
@@ -192,6 +282,11 @@ big_integer big_integer::operator~() const {
 }
 
 big_integer& big_integer::operator++() {
+    // no carry out of the lowest limb
+    if (!negate_ && !data_.empty() && data_[0] != LIMB_MAX) {
+        ++data_[0];
+        return *this;
+    }
     return (*this) += 1;
 }
 
@@ -202,8 +297,16 @@ big_integer big_integer::operator++(int) {
 }
 
 big_integer& big_integer::operator--() {
+    // no borrow and the magnitude stays nonzero
+    if (negate_ && data_[0] != LIMB_MAX) {
+        ++data_[0];
+        return *this;
+    }
+    if (!negate_ && !data_.empty() && data_[0] > 1) {
+        --data_[0];
+        return *this;
+    }
     return (*this) -= 1;
-
 }
 
 big_integer big_integer::operator--(int) {
@@ -212,48 +315,150 @@ big_integer big_integer::operator--(int) {
     return tmp;
 }
 
+// returning the parameter itself moves it; returning a += b would copy
 big_integer operator+(big_integer a, big_integer const& b) {
-    return a += b;
+    a += b;
+    return a;
 }
 
 big_integer operator-(big_integer a, big_integer const& b) {
-    return a -= b;
+    a -= b;
+    return a;
 }
 
 big_integer operator*(big_integer a, big_integer const& b) {
-    return a *= b;
+    a *= b;
+    return a;
 }
 
 big_integer operator/(big_integer a, big_integer const& b) {
-    return a /= b;
+    a /= b;
+    return a;
 }
 
 big_integer operator%(big_integer a, big_integer const& b) {
-    return a %= b;
+    a %= b;
+    return a;
 }
 
 big_integer operator&(big_integer a, big_integer const& b) {
-    return a &= b;
+    a &= b;
+    return a;
 }
 
 big_integer operator|(big_integer a, big_integer const& b) {
-    return a |= b;
+    a |= b;
+    return a;
 }
 
 big_integer operator^(big_integer a, big_integer const& b) {
-    return a ^= b;
+    a ^= b;
+    return a;
+}
+
+big_integer operator+(big_integer const& a, big_integer&& b) {
+    return std::move(b += a);
+}
+
+big_integer operator-(big_integer const& a, big_integer&& b) {
+    b -= a;
+    b.flip_sign();
+    return std::move(b);
+}
+
+big_integer operator*(big_integer const& a, big_integer&& b) {
+    return std::move(b *= a);
+}
+
+big_integer operator&(big_integer const& a, big_integer&& b) {
+    return std::move(b &= a);
+}
+
+big_integer operator|(big_integer const& a, big_integer&& b) {
+    return std::move(b |= a);
+}
+
+big_integer operator^(big_integer const& a, big_integer&& b) {
+    return std::move(b ^= a);
+}
+
+big_integer operator+(big_integer&& a, big_integer&& b) {
+    return a.data_.capacity() >= b.data_.capacity() ? std::move(a += b) : std::move(b += a);
+}
+
+big_integer operator-(big_integer&& a, big_integer&& b) {
+    return a.data_.capacity() >= b.data_.capacity() ? std::move(a -= b) : a - std::move(b);
+}
+
+big_integer operator*(big_integer&& a, big_integer&& b) {
+    return a.data_.capacity() >= b.data_.capacity() ? std::move(a *= b) : std::move(b *= a);
+}
+
+big_integer operator&(big_integer&& a, big_integer&& b) {
+    return a.data_.capacity() >= b.data_.capacity() ? std::move(a &= b) : std::move(b &= a);
+}
+
+big_integer operator|(big_integer&& a, big_integer&& b) {
+    return a.data_.capacity() >= b.data_.capacity() ? std::move(a |= b) : std::move(b |= a);
+}
+
+big_integer operator^(big_integer&& a, big_integer&& b) {
+    return a.data_.capacity() >= b.data_.capacity() ? std::move(a ^= b) : std::move(b ^= a);
 }
 
 big_integer operator<<(big_integer a, int b) {
-    return a <<= b;
+    a <<= b;
+    return a;
 }
 
 big_integer operator>>(big_integer a, int b) {
-    return a >>= b;
+    a >>= b;
+    return a;
+}
+
+big_integer square(big_integer const& a) {
+    big_integer result;
+    result.data_.resize(2 * a.data_.size());
+    magnitude::sqr(result.data_.data(), a.data_.data(), a.data_.size());
+    result.normalize();
+    return result;
+}
+
+void addmul(big_integer& acc, big_integer const& a, big_integer const& b) {
+    acc.add_product(a, b.data_.data(), b.data_.size(), b.negate_);
+}
+
+void submul(big_integer& acc, big_integer const& a, big_integer const& b) {
+    acc.add_product(a, b.data_.data(), b.data_.size(), !b.negate_);
+}
+
+void addmul_limb(big_integer& acc, big_integer const& a, uint32_t b) {
+    magnitude::limb_t limb = b;
+    acc.add_product(a, &limb, b == 0 ? 0 : 1, false);
+}
+
+std::pair<big_integer, big_integer> divmod(big_integer const& a, big_integer const& b) {
+    std::pair<big_integer, big_integer> result(a, big_integer());
+    big_integer& quotient = result.first;
+    big_integer& remainder = result.second;
+    quotient.divide(b, false, &remainder);
+    quotient.negate_ = a.negate_ != b.negate_;
+    quotient.normalize();
+    remainder.negate_ = a.negate_;
+    remainder.normalize();
+    return result;
+}
+
+int compare(big_integer const& a, big_integer const& b) {
+    if (a.negate_ != b.negate_) {
+        return a.negate_ ? -1 : 1;
+    }
+    int result = a.compare_magnitude(b);
+    return a.negate_ ? -result : result;
 }
 
 bool operator==(big_integer const& a, big_integer const& b) {
-    return to_string(a) == to_string(b);
+    return a.negate_ == b.negate_ && a.data_ == b.data_;
 }
 
 bool operator!=(big_integer const& a, big_integer const& b) {
@@ -261,40 +466,39 @@ bool operator!=(big_integer const& a, big_integer const& b) {
 }
 
 bool operator<(big_integer const& a, big_integer const& b) {
-    if (a.negate_ != b.negate_) {
-        return a.negate_;
-    }
-    return (a.compare(b) == -1);
+    return compare(a, b) < 0;
 }
 
 bool operator>(big_integer const& a, big_integer const& b) {
-    if (a.negate_ != b.negate_) {
-        return b.negate_;
-    }
-    return (a.compare(b) == 1);
+    return compare(a, b) > 0;
 }
 
 bool operator<=(big_integer const& a, big_integer const& b) {
-    return !(a > b);
+    return compare(a, b) <= 0;
 }
 
 bool operator>=(big_integer const& a, big_integer const& b) {
-    return !(a < b);
-}
-
-std::string to_string(big_integer const& a) {
-    if (a.is_zero()) {
-        return "0";
-    }
-    std::string result;
-    big_integer x(a);
-    if (x.negate_) x = -x;
-    while (!x.is_zero()) {
-        result += std::to_string(x.mod());
+    return compare(a, b) >= 0;
+}
+
+// multiply-xorshift over pairs of limbs, finished with the MurmurHash3 64-bit mixer
+size_t std::hash<big_integer>::operator()(big_integer const& a) const noexcept {
+    uint64_t h = a.negate_ ? 0x9e3779b97f4a7c15ULL : 0;
+    magnitude::limb_t const* p = a.data_.data();
+    size_t n = a.data_.size();
+    size_t step = 64 / LIMB_BITS;
+    for (size_t i = 0; i < n; i += step) {
+        uint64_t word = p[i];
+        if (step == 2 && i + 1 < n) {
+            word |= static_cast<uint64_t>(p[i + 1]) << 32;
+        }
+        h = (h ^ word) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 32;
     }
-    if (a.negate_) result += '-';
-    std::reverse(result.begin(), result.end());
-    return result;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
 }
 
 std::ostream& operator<<(std::ostream& s, big_integer const& a) {
@@ -302,120 +506,187 @@ std::ostream& operator<<(std::ostream& s, big_integer const& a) {
 }
 
 bool big_integer::is_zero() const {
-    return (!negate_ && data_.size() == 1 && data_.back() == 0);
+    return data_.empty();
 }
 
 
-void big_integer::divide(big_integer b) {
-    if (data_.size() < b.data_.size()) {
-        data_ = std::vector<uint32_t>(1, 0);
+void big_integer::divide(big_integer const& rhs, bool remainder, big_integer* other) {
+    if (compare_magnitude(rhs) < 0) {
+        if (remainder) {
+            if (other != nullptr) {
+                other->data_.clear();
+            }
+        } else {
+            if (other != nullptr) {
+                other->data_ = data_;
+            }
+            data_.clear();
+        }
         return;
     }
-
-    size_t shift = 1;
-    while (b.data_.back() * shift < (1U << (BITS - 1))) {
-        shift <<= 1;
+    size_t size = data_.size();
+    size_t rhs_size = rhs.data_.size();
+    if (size <= 2) {
+        double_limb_t x = low_limbs();
+        double_limb_t y = rhs.low_limbs();
+        set_magnitude(remainder ? x % y : x / y);
+        if (other != nullptr) {
+            other->set_magnitude(remainder ? x / y : x % y);
+        }
+        return;
     }
-
-    (*this) *= shift;
-    b *= shift;
-
-    size_t n = b.data_.size();
-    size_t m = data_.size() - b.data_.size();
-
-    std::reverse(b.data_.begin(), b.data_.end());
-    b.data_.resize(b.data_.size() + m);
-    std::reverse(b.data_.begin(), b.data_.end());
-
-    std::vector<uint32_t> result(m + 1, 0);
-    result[m] = 1;
-
-    if ((*this) >= (result[m] * b)) {
-        (*this) -= (result[m] * b);
-    } else {
-        result[m] = 0;
-    }
-
-    for (size_t i = m - 1; i < m; --i) {
-        b.data_.erase(b.data_.begin());
-        result[i] = std::min(
-            (((take_n(n + i, *this) * 1ULL) << BITS) | take_n(n + i - 1, *this)) / b.data_.back(),
-            (1ULL << BITS) - 1);
-        *this -= result[i] * b;
-        while (*this < 0) {
-            --result[i];
-            *this += b;
+    if (rhs_size == 1) {
+        limb_t r = magnitude::divmod_1(data_.data(), data_.data(), size, rhs.data_[0]);
+        if (remainder) {
+            if (other != nullptr) {
+                std::swap(other->data_, data_);
+            }
+            set_magnitude(r);
+        } else if (other != nullptr) {
+            other->set_magnitude(r);
         }
+        return;
+    }
+    // the wanted part is written over the dividend, the other one goes to other or to scratch memory
+    size_t other_size = remainder ? size - rhs_size + 1 : rhs_size;
+    magnitude::scratch_frame frame;
+    magnitude::scratch_buffer temporary;
+    storage kept;
+    limb_t* other_part;
+    if (other != nullptr) {
+        kept.resize(other_size);
+        other_part = kept.data();
+    } else {
+        temporary.resize(other_size);
+        other_part = temporary.data();
     }
-    data_ = result;
+    limb_t* q = remainder ? other_part : data_.data();
+    limb_t* r = remainder ? data_.data() : other_part;
+    magnitude::divmod(q, r, data_.data(), size, rhs.data_.data(), rhs_size);
+    data_.resize(remainder ? rhs_size : size - rhs_size + 1);
+    if (other != nullptr) {
+        std::swap(other->data_, kept);
+    }
+}
+
+void big_integer::flip_sign() {
+    negate_ = !negate_ && !is_zero();
 }
 
 void big_integer::normalize() {
-    uint32_t nil = negate_ ? UINT32_MAX : 0;
-    while (data_.size() > 1 && data_.back() == nil) {
+    while (!data_.empty() && data_.back() == 0) {
         data_.pop_back();
     }
+    if (data_.empty()) {
+        negate_ = false;
+    }
 }
 
-int big_integer::compare(big_integer const& other) const {
+void big_integer::add_product(big_integer const& a, limb_t const* b, size_t bn, bool negative) {
+    size_t an = a.data_.size();
+    if (an == 0 || bn == 0) {
+        return;
+    }
+    if (&a == this || b == data_.data()) {
+        // the accumulator is an operand
+        big_integer product;
+        product.data_.resize(an + bn);
+        magnitude::mul(product.data_.data(), a.data_.data(), an, b, bn);
+        product.negate_ = a.negate_ != negative;
+        product.normalize();
+        *this += product;
+        return;
+    }
+    bool product_negative = a.negate_ != negative;
+    if (is_zero()) {
+        negate_ = product_negative;
+    }
+    if (data_.size() < an + bn) {
+        data_.resize(an + bn);
+    }
+    if (negate_ == product_negative) {
+        limb_t carry = magnitude::addmul(data_.data(), data_.size(), a.data_.data(), an, b, bn);
+        if (carry != 0) {
+            data_.push_back(carry);
+        }
+    } else if (magnitude::submul(data_.data(), data_.size(), a.data_.data(), an, b, bn) != 0) {
+        // the product was larger: the magnitude wrapped around to its two's complement
+        magnitude::neg(data_.data(), data_.data(), data_.size());
+        negate_ = !negate_;
+    }
+    normalize();
+}
+
+int big_integer::compare_magnitude(big_integer const& other) const {
     // return
     // -1 abs(this) < abs(other)
     // 0 ==
     // 1 >
-    if (data_.size() > other.data_.size()) {
-        return 1;
-    }
-    if (data_.size() < other.data_.size()) {
-        return -1;
+    if (data_.size() != other.data_.size()) {
+        return data_.size() < other.data_.size() ? -1 : 1;
     }
-    for (size_t i = data_.size(); i != 0; ) {
-        --i;
-        if (data_[i] != other.data_[i]) {
-            return (data_[i] < other.data_[i]) ? -1 : 1;
+    return magnitude::compare(data_.data(), data_.size(), other.data_.data(), other.data_.size());
+}
+
+void big_integer::add_subtract(big_integer const& rhs, bool subtract) {
+    bool rhs_negate = rhs.negate_ != subtract;
+    size_t size = data_.size();
+    size_t rhs_size = rhs.data_.size();
+
+    if (size <= 1 && rhs_size <= 1) {
+        double_limb_t x = low_limbs();
+        double_limb_t y = rhs.low_limbs();
+        if (negate_ == rhs_negate || x == 0) {
+            negate_ = rhs_negate;
+            set_magnitude(x + y);
+        } else if (x >= y) {
+            set_magnitude(x - y);
+        } else {
+            negate_ = rhs_negate;
+            set_magnitude(y - x);
         }
+        return;
     }
-    return 0;
-}
 
-uint32_t big_integer::mod()
-{
-    uint64_t carry = 0;
-    for (size_t i = data_.size(); i != 0;)
-    {
-        --i;
-        carry = data_[i] + (carry << BITS);
-        data_[i] = carry / BASE;
-        carry = carry % BASE;
+    if (negate_ == rhs_negate || is_zero()) {
+        negate_ = rhs_negate;
+        // the buffer grows only for a longer rhs (which is then not *this) or a carry out
+        limb_t carry;
+        if (size >= rhs_size) {
+            carry = magnitude::add(data_.data(), data_.data(), size, rhs.data_.data(), rhs_size);
+        } else {
+            data_.resize(rhs_size);
+            carry = magnitude::add(data_.data(), rhs.data_.data(), rhs_size, data_.data(), size);
+        }
+        if (carry != 0) {
+            data_.push_back(carry);
+        }
+    } else if (compare_magnitude(rhs) >= 0) {
+        magnitude::sub(data_.data(), data_.data(), size, rhs.data_.data(), rhs_size);
+    } else {
+        data_.resize(rhs_size);
+        magnitude::sub(data_.data(), rhs.data_.data(), rhs_size, data_.data(), size);
+        negate_ = rhs_negate;
     }
     normalize();
-    return carry;
-}
-
-uint32_t big_integer::take_n(size_t i, big_integer const& x) {
-    return i < x.data_.size() ? x.data_[i] : (x.negate_ ? UINT32_MAX : 0);
-}
-
-void big_integer::resize(size_t new_size) {
-    data_.resize(new_size + 2, negate_ ? UINT32_MAX : 0);
 }
 
-void big_integer::bit_operator(const std::function<uint32_t (uint32_t, uint32_t)>& f, big_integer const& rhs) {
-    resize(std::max(data_.size(), rhs.data_.size()));
-    for (size_t i = 0; i < data_.size(); ++i) {
-        data_[i] = f(data_[i], take_n(i, rhs));
+big_integer::double_limb_t big_integer::low_limbs() const {
+    double_limb_t result = 0;
+    for (size_t i = std::min<size_t>(data_.size(), 2); i != 0;) {
+        --i;
+        result = result << LIMB_BITS | data_[i];
     }
-    negate_ = f(static_cast<uint32_t>(negate_), static_cast<uint32_t>(rhs.negate_)) == 1;
-    normalize();
+    return result;
 }
 
-void big_integer::add_subtract(const std::function<uint64_t (uint32_t, uint64_t)>& f, big_integer const& rhs) {
-    uint64_t carry = 0;
-    resize(std::max(data_.size(), rhs.data_.size()));
-    for (size_t i = 0; i < data_.size(); ++i) {
-        carry = f(data_[i], carry + take_n(i, rhs));
-        data_[i] = carry;
-        carry = (carry >> BITS) != 0;
+void big_integer::set_magnitude(double_limb_t value) {
+    data_.clear();
+    while (value != 0) {
+        data_.push_back(static_cast<limb_t>(value));
+        value >>= LIMB_BITS;
+    }
+    if (data_.empty()) {
+        negate_ = false;
     }
-    negate_ = (data_.back() >> (BITS - 1)) == 1;
-    normalize();
 }
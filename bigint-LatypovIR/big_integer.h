@@ -1,14 +1,43 @@
 #pragma once
 
+#include <functional>
 #include <iosfwd>
 #include <string>
+#include <utility>
 #include <vector>
-#include <functional>
+
+#include "limb_memory.h"
+#include "limb_vector.h"
+#include "magnitude.h"
+
+// numbers of up to that many limbs (128 bits by default) are stored inside big_integer, without a heap allocation
+#ifndef BIGINT_INLINE_LIMBS
+#define BIGINT_INLINE_LIMBS (128 / BIGINT_LIMB_BITS)
+#endif
+
+struct big_integer;
+
+// order of bytes in the binary representation: the least or the most significant byte first
+enum class byte_order
+{
+    little_endian,
+    big_endian
+};
+
+namespace std
+{
+    template <>
+    struct hash<big_integer>
+    {
+        size_t operator()(big_integer const& a) const noexcept;
+    };
+}
 
 struct big_integer
 {
     big_integer();
     big_integer(big_integer const& other);
+    big_integer(big_integer&& other) noexcept;
 
     big_integer(int a);
     big_integer(unsigned int a);
@@ -17,15 +46,23 @@ struct big_integer
     big_integer(long long int a);
     big_integer(unsigned long long int a);
     explicit big_integer(std::string const& str);
+    // radix is 10 or a power of two up to 32
+    big_integer(std::string const& str, int radix);
+    // magnitude from size 32-bit words or bytes, as written by to_words and to_bytes; the words are copied at once
+    big_integer(uint32_t const* words, size_t size, bool negative = false);
+    big_integer(unsigned char const* bytes, size_t size, byte_order order, bool negative = false);
     ~big_integer();
 
     big_integer& operator=(big_integer const& other);
+    big_integer& operator=(big_integer&& other) noexcept;
 
     big_integer& operator+=(big_integer const& rhs);
     big_integer& operator-=(big_integer const& rhs);
     big_integer& operator*=(big_integer const& rhs);
     big_integer& operator/=(big_integer const& rhs);
     big_integer& operator%=(big_integer const& rhs);
+    // *this /= divisor, returns *this % divisor (with the sign of the dividend); costs a multiplication per limb
+    long long divmod_small(uint32_t divisor);
 
     big_integer& operator&=(big_integer const& rhs);
     big_integer& operator|=(big_integer const& rhs);
@@ -34,6 +71,38 @@ struct big_integer
     big_integer& operator<<=(int rhs);
     big_integer& operator>>=(int rhs);
 
+    // bits of the magnitude: its length (0 for zero) and the number of ones
+    size_t bit_length() const;
+    size_t popcount() const;
+    // bits of the infinite two's complement representation, as in the bitwise operators
+    bool test_bit(size_t index) const;
+    void set_bit(size_t index, bool value = true);
+
+    // read-only view of the magnitude, least significant limb first; valid until the number is modified
+    struct limb_view
+    {
+        magnitude::limb_t const* first;
+        size_t count;
+
+        magnitude::limb_t const* begin() const
+        {
+            return first;
+        }
+        magnitude::limb_t const* end() const
+        {
+            return first + count;
+        }
+        size_t size() const
+        {
+            return count;
+        }
+        magnitude::limb_t operator[](size_t index) const
+        {
+            return first[index];
+        }
+    };
+    limb_view limbs() const;
+
     big_integer operator+() const;
     big_integer operator-() const;
     big_integer operator~() const;
@@ -50,23 +119,66 @@ struct big_integer
     friend bool operator>(big_integer const& a, big_integer const& b);
     friend bool operator<=(big_integer const& a, big_integer const& b);
     friend bool operator>=(big_integer const& a, big_integer const& b);
+    // -1, 0 or 1 as a is less than, equal to or greater than b
+    friend int compare(big_integer const& a, big_integer const& b);
+    friend struct std::hash<big_integer>;
+
+    friend big_integer operator-(big_integer const& a, big_integer&& b);
+    // both operands are temporaries: the result takes the larger buffer
+    friend big_integer operator+(big_integer&& a, big_integer&& b);
+    friend big_integer operator-(big_integer&& a, big_integer&& b);
+    friend big_integer operator*(big_integer&& a, big_integer&& b);
+    friend big_integer operator&(big_integer&& a, big_integer&& b);
+    friend big_integer operator|(big_integer&& a, big_integer&& b);
+    friend big_integer operator^(big_integer&& a, big_integer&& b);
+
+    friend big_integer square(big_integer const& a);
+    // acc += a * b and acc -= a * b without a temporary big_integer for the product
+    friend void addmul(big_integer& acc, big_integer const& a, big_integer const& b);
+    friend void submul(big_integer& acc, big_integer const& a, big_integer const& b);
+    friend void addmul_limb(big_integer& acc, big_integer const& a, uint32_t b);
+
+    // {a / b, a % b} computed by one division
+    friend std::pair<big_integer, big_integer> divmod(big_integer const& a, big_integer const& b);
 
     friend std::string to_string(big_integer const& a);
+    friend std::string to_string(big_integer const& a, int radix);
+    // magnitude without leading zeros (empty for zero); the sign is not stored
+    friend std::vector<uint32_t> to_words(big_integer const& a);
+    friend std::vector<unsigned char> to_bytes(big_integer const& a, byte_order order);
+
+    friend struct modular_context;
+    friend struct gcd_reduction;
 
 private:
+    // sign and magnitude; the magnitude has no leading zero limbs, zero is empty and never negative
+    using limb_t = magnitude::limb_t;
+    using double_limb_t = magnitude::double_limb_t;
+    using storage = limb_vector<limb_t, BIGINT_INLINE_LIMBS, magnitude::limb_allocator<limb_t>>;
+
     bool negate_;
-    std::vector<uint32_t> data_;
+    storage data_;
 
     bool is_zero() const;
     void normalize();
-    uint32_t mod();
-
-    void resize(size_t new_size);
-    void divide(big_integer b);
-    int compare(big_integer const& other) const;
-    static uint32_t take_n(size_t i, big_integer const& x);
-    void add_subtract(const std::function<uint64_t (uint32_t, uint64_t)>& f, big_integer const& rhs);
-    void bit_operator(const std::function<uint32_t (uint32_t, uint32_t)>& f, big_integer const& rhs);
+    void flip_sign();
+    // the lowest two limbs of the magnitude, and setting a magnitude of at most two limbs
+    double_limb_t low_limbs() const;
+    void set_magnitude(double_limb_t value);
+
+    static big_integer const& decimal_power(size_t level);
+    void from_decimal(char const* first, char const* last);
+    // appends decimal digits of the magnitude, padded with zeros to width
+    void to_decimal(std::string& out, size_t width) const;
+
+    // replaces the magnitude by the quotient or the remainder of magnitudes; other, if given, receives the other one
+    void divide(big_integer const& rhs, bool remainder, big_integer* other = nullptr);
+    int compare_magnitude(big_integer const& other) const;
+    void add_subtract(big_integer const& rhs, bool subtract);
+    // += a * b for a b of bn limbs and the given sign
+    void add_product(big_integer const& a, limb_t const* b, size_t bn, bool negative);
+    template <typename Op>
+    void bit_operator(Op op, big_integer const& rhs);
 };
 
 
@@ -80,16 +192,51 @@ big_integer operator&(big_integer a, big_integer const& b);
 big_integer operator|(big_integer a, big_integer const& b);
 big_integer operator^(big_integer a, big_integer const& b);
 
+// a temporary right operand is reused for the result
+big_integer operator+(big_integer const& a, big_integer&& b);
+big_integer operator-(big_integer const& a, big_integer&& b);
+big_integer operator*(big_integer const& a, big_integer&& b);
+big_integer operator&(big_integer const& a, big_integer&& b);
+big_integer operator|(big_integer const& a, big_integer&& b);
+big_integer operator^(big_integer const& a, big_integer&& b);
+
+big_integer operator+(big_integer&& a, big_integer&& b);
+big_integer operator-(big_integer&& a, big_integer&& b);
+big_integer operator*(big_integer&& a, big_integer&& b);
+big_integer operator&(big_integer&& a, big_integer&& b);
+big_integer operator|(big_integer&& a, big_integer&& b);
+big_integer operator^(big_integer&& a, big_integer&& b);
+
 big_integer operator<<(big_integer a, int b);
 big_integer operator>>(big_integer a, int b);
 
+big_integer square(big_integer const& a);
+std::pair<big_integer, big_integer> divmod(big_integer const& a, big_integer const& b);
+void addmul(big_integer& acc, big_integer const& a, big_integer const& b);
+void submul(big_integer& acc, big_integer const& a, big_integer const& b);
+void addmul_limb(big_integer& acc, big_integer const& a, uint32_t b);
+
+// floor of the square root and of the k-th root, by Newton's iteration from a root of the leading half;
+// a negative argument throws std::domain_error, except for an odd k, where the root is rounded toward zero
+big_integer isqrt(big_integer const& a);
+big_integer iroot(big_integer const& a, unsigned k);
+// nonnegative gcd and lcm; gcd(0, 0) = 0
+big_integer gcd(big_integer const& a, big_integer const& b);
+big_integer lcm(big_integer const& a, big_integer const& b);
+// returns g = gcd(a, b) and sets x, y to cofactors with a * x + b * y = g, |x| <= |b| / 2g for a nonzero b
+big_integer extended_gcd(big_integer const& a, big_integer const& b, big_integer& x, big_integer& y);
+
 bool operator==(big_integer const& a, big_integer const& b);
 bool operator!=(big_integer const& a, big_integer const& b);
 bool operator<(big_integer const& a, big_integer const& b);
 bool operator>(big_integer const& a, big_integer const& b);
 bool operator<=(big_integer const& a, big_integer const& b);
 bool operator>=(big_integer const& a, big_integer const& b);
+int compare(big_integer const& a, big_integer const& b);
 
 std::string to_string(big_integer const& a);
+std::string to_string(big_integer const& a, int radix);
+std::vector<uint32_t> to_words(big_integer const& a);
+std::vector<unsigned char> to_bytes(big_integer const& a, byte_order order);
 std::ostream& operator<<(std::ostream& s, big_integer const& a);
 
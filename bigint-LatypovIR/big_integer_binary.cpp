@@ -0,0 +1,157 @@
+#include "big_integer.h"
+#include "magnitude.h"
+
+#include <cstring>
+
+// Binary import and export of the magnitude: 32-bit words in the limb order, or bytes in either order.
+// On a little-endian host the limbs are laid out as the little-endian bytes and words, which are copied at once;
+// otherwise whole limbs are assembled from bytes with a byte swap (32-bit words still map to 32-bit limbs directly).
+namespace
+{
+    using magnitude::LIMB_BITS;
+    using magnitude::limb_t;
+
+    size_t constexpr WORDS_PER_LIMB = LIMB_BITS / 32;
+    size_t constexpr BYTES_PER_LIMB = LIMB_BITS / 8;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    bool constexpr LITTLE_ENDIAN_HOST = true;
+#else
+    bool constexpr LITTLE_ENDIAN_HOST = false;
+#endif
+    bool constexpr WORDS_ARE_LIMBS = LITTLE_ENDIAN_HOST || WORDS_PER_LIMB == 1;
+
+    // a limb from or to BYTES_PER_LIMB bytes in the given order; compilers turn these loops into a load and a swap
+    limb_t load_limb(unsigned char const* bytes, byte_order order)
+    {
+        limb_t result = 0;
+        for (size_t i = 0; i < BYTES_PER_LIMB; ++i)
+        {
+            limb_t byte = bytes[order == byte_order::big_endian ? i : BYTES_PER_LIMB - 1 - i];
+            result = result << 8 | byte;
+        }
+        return result;
+    }
+
+    void store_limb(unsigned char* bytes, limb_t value, byte_order order)
+    {
+        for (size_t i = 0; i < BYTES_PER_LIMB; ++i)
+        {
+            bytes[order == byte_order::little_endian ? i : BYTES_PER_LIMB - 1 - i] = static_cast<unsigned char>(value);
+            value >>= 8;
+        }
+    }
+
+    // position of the i-th limb's bytes in an array of size bytes
+    size_t limb_offset(size_t i, size_t size, byte_order order)
+    {
+        return order == byte_order::little_endian ? i * BYTES_PER_LIMB : size - (i + 1) * BYTES_PER_LIMB;
+    }
+
+    // position of the i-th least significant byte
+    size_t byte_offset(size_t i, size_t size, byte_order order)
+    {
+        return order == byte_order::little_endian ? i : size - 1 - i;
+    }
+}
+
+big_integer::big_integer(uint32_t const* words, size_t size, bool negative) : big_integer()
+{
+    while (size > 0 && words[size - 1] == 0)
+    {
+        --size;
+    }
+    data_.resize((size + WORDS_PER_LIMB - 1) / WORDS_PER_LIMB);
+    if (WORDS_ARE_LIMBS)
+    {
+        if (size != 0)
+        {
+            // the last limb may be half filled, its high word is already zero
+            std::memcpy(data_.data(), words, size * sizeof(uint32_t));
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            data_[i / WORDS_PER_LIMB] |= static_cast<limb_t>(words[i]) << (i % WORDS_PER_LIMB * 32);
+        }
+    }
+    negate_ = negative && !data_.empty();
+}
+
+big_integer::big_integer(unsigned char const* bytes, size_t size, byte_order order, bool negative) : big_integer()
+{
+    data_.resize((size + BYTES_PER_LIMB - 1) / BYTES_PER_LIMB);
+    if (LITTLE_ENDIAN_HOST && order == byte_order::little_endian)
+    {
+        if (size != 0)
+        {
+            std::memcpy(data_.data(), bytes, size);
+        }
+    }
+    else
+    {
+        size_t whole = size / BYTES_PER_LIMB;
+        for (size_t i = 0; i < whole; ++i)
+        {
+            data_[i] = load_limb(bytes + limb_offset(i, size, order), order);
+        }
+        for (size_t i = whole * BYTES_PER_LIMB; i < size; ++i)
+        {
+            limb_t byte = bytes[byte_offset(i, size, order)];
+            data_[whole] |= byte << (i % BYTES_PER_LIMB * 8);
+        }
+    }
+    normalize();
+    negate_ = negative && !data_.empty();
+}
+
+big_integer::limb_view big_integer::limbs() const
+{
+    return {data_.data(), data_.size()};
+}
+
+std::vector<uint32_t> to_words(big_integer const& a)
+{
+    std::vector<uint32_t> result((a.bit_length() + 31) / 32);
+    if (WORDS_ARE_LIMBS)
+    {
+        if (!result.empty())
+        {
+            std::memcpy(result.data(), a.data_.data(), result.size() * sizeof(uint32_t));
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < result.size(); ++i)
+        {
+            result[i] = static_cast<uint32_t>(a.data_[i / WORDS_PER_LIMB] >> (i % WORDS_PER_LIMB * 32));
+        }
+    }
+    return result;
+}
+
+std::vector<unsigned char> to_bytes(big_integer const& a, byte_order order)
+{
+    size_t size = (a.bit_length() + 7) / 8;
+    std::vector<unsigned char> result(size);
+    if (LITTLE_ENDIAN_HOST && order == byte_order::little_endian)
+    {
+        if (size != 0)
+        {
+            std::memcpy(result.data(), a.data_.data(), size);
+        }
+        return result;
+    }
+    size_t whole = size / BYTES_PER_LIMB;
+    for (size_t i = 0; i < whole; ++i)
+    {
+        store_limb(result.data() + limb_offset(i, size, order), a.data_[i], order);
+    }
+    for (size_t i = whole * BYTES_PER_LIMB; i < size; ++i)
+    {
+        result[byte_offset(i, size, order)] = static_cast<unsigned char>(a.data_[whole] >> (i % BYTES_PER_LIMB * 8));
+    }
+    return result;
+}
@@ -0,0 +1,338 @@
+#include "big_integer.h"
+#include "magnitude.h"
+
+#include <algorithm>
+#include <utility>
+
+// Greatest common divisors. Short numbers go through Lehmer's algorithm on limbs; long ones are reduced
+// by half-gcd recursion: the leading half of a and b determines a matrix of Euclid steps that takes them
+// to about three quarters of their length, a second recursion on the leading part of the result takes them
+// to half, so a gcd costs O(M(n) log n). Every step is unimodular, which keeps the gcd whatever the quotients.
+struct gcd_reduction
+{
+    using limb_t = magnitude::limb_t;
+
+    // (a; b) before the reduction = (m00 m01; m10 m11) (a; b) after it
+    struct matrix
+    {
+        big_integer m00 = 1;
+        big_integer m01 = 0;
+        big_integer m10 = 0;
+        big_integer m11 = 1;
+        int determinant = 1;
+
+        // *this = *this * x
+        void multiply(matrix&& x)
+        {
+            if (m00 == 1 && m01 == 0 && m10 == 0 && m11 == 1)
+            {
+                *this = std::move(x);
+                return;
+            }
+            big_integer r00 = m00 * x.m00;
+            addmul(r00, m01, x.m10);
+            big_integer r01 = m00 * x.m01;
+            addmul(r01, m01, x.m11);
+            big_integer r10 = m10 * x.m00;
+            addmul(r10, m11, x.m10);
+            big_integer r11 = m10 * x.m01;
+            addmul(r11, m11, x.m11);
+            m00 = std::move(r00);
+            m01 = std::move(r01);
+            m10 = std::move(r10);
+            m11 = std::move(r11);
+            determinant *= x.determinant;
+        }
+
+        // *this = *this * (q 1; 1 0)
+        void multiply_quotient(big_integer const& q)
+        {
+            addmul(m01, m00, q);
+            addmul(m11, m10, q);
+            std::swap(m00, m01);
+            std::swap(m10, m11);
+            determinant = -determinant;
+        }
+    };
+
+    static big_integer gcd(big_integer a, big_integer b)
+    {
+        a.negate_ = false;
+        b.negate_ = false;
+        if (a.compare_magnitude(b) < 0)
+        {
+            std::swap(a, b);
+        }
+        reduce(a, b, nullptr);
+        return a;
+    }
+
+    static big_integer extended_gcd(big_integer const& a, big_integer const& b, big_integer& x, big_integer& y)
+    {
+        big_integer g = a;
+        big_integer h = b;
+        g.negate_ = false;
+        h.negate_ = false;
+        bool swapped = g.compare_magnitude(h) < 0;
+        if (swapped)
+        {
+            std::swap(g, h);
+        }
+        matrix m;
+        reduce(g, h, &m);
+        if (g.is_zero())
+        {
+            x = 0;
+            y = 0;
+            return g;
+        }
+        if (b.is_zero())
+        {
+            x = a.negate_ ? -1 : 1;
+            y = 0;
+            return g;
+        }
+        // (g; 0) = m^-1 (|a|; |b|) = determinant (m11 -m01; -m10 m00) (|a|; |b|), up to the order
+        big_integer s = swapped ? m.m01 : m.m11;
+        if ((m.determinant > 0) == swapped)
+        {
+            s.flip_sign();
+        }
+        if (a.negate_)
+        {
+            s.flip_sign();
+        }
+        // s is determined modulo |b| / g; the smallest one gives the smallest t
+        big_integer period = b / g;
+        period.negate_ = false;
+        s %= period;
+        big_integer twice = s << 1;
+        twice.negate_ = false;
+        if (twice.compare_magnitude(period) > 0)
+        {
+            s += s.negate_ ? period : -period;
+        }
+        y = (g - a * s) / b;
+        x = std::move(s);
+        return g;
+    }
+
+private:
+    static big_integer low_bits(big_integer const& a, size_t bits)
+    {
+        big_integer result;
+        size_t limbs = std::min(a.data_.size(), (bits + magnitude::LIMB_BITS - 1) / magnitude::LIMB_BITS);
+        result.data_.resize(limbs);
+        std::copy(a.data_.begin(), a.data_.begin() + limbs, result.data_.begin());
+        if (limbs * magnitude::LIMB_BITS > bits)
+        {
+            result.data_[limbs - 1] &= (limb_t(1) << bits % magnitude::LIMB_BITS) - 1;
+        }
+        result.normalize();
+        return result;
+    }
+
+    static void euclid_step(big_integer& a, big_integer& b, matrix* m)
+    {
+        std::pair<big_integer, big_integer> qr = divmod(a, b);
+        a = std::move(b);
+        b = std::move(qr.second);
+        if (m != nullptr)
+        {
+            m->multiply_quotient(qr.first);
+        }
+    }
+
+    // (x, y) = (x s00 + y s10, x s01 + y s11) for nonnegative x and y, one row of a matrix product
+    static void combine(big_integer& x, big_integer& y, magnitude::lehmer_matrix const& s, magnitude::scratch_buffer& t)
+    {
+        size_t n = std::max(x.data_.size(), y.data_.size());
+        x.data_.resize(n + 1);
+        y.data_.resize(n + 1);
+        t.resize(2 * (n + 1));
+        limb_t* u = t.data();
+        limb_t* v = u + n + 1;
+        u[n] = magnitude::mul_1(u, x.data_.data(), n, s.m00);
+        u[n] += magnitude::addmul_1(u, y.data_.data(), n, s.m10);
+        v[n] = magnitude::mul_1(v, x.data_.data(), n, s.m01);
+        v[n] += magnitude::addmul_1(v, y.data_.data(), n, s.m11);
+        std::copy(u, v, x.data_.begin());
+        std::copy(v, v + n + 1, y.data_.begin());
+        x.normalize();
+        y.normalize();
+    }
+
+    // Lehmer steps until b has at most `bits` bits
+    static void lehmer(big_integer& a, big_integer& b, matrix* m, size_t bits)
+    {
+        // the steps so far, a nonnegative matrix updated in place
+        matrix steps;
+        magnitude::scratch_frame frame;
+        magnitude::scratch_buffer scratch;
+        while (b.bit_length() > bits)
+        {
+            size_t n = a.data_.size();
+            b.data_.resize(n);
+            magnitude::lehmer_matrix step;
+            if (!magnitude::lehmer_cofactors(step, a.data_.data(), b.data_.data(), n))
+            {
+                b.normalize();
+                euclid_step(a, b, m != nullptr ? &steps : nullptr);
+                continue;
+            }
+            scratch.resize(2 * n);
+            magnitude::lehmer_apply(a.data_.data(), b.data_.data(), n, step, scratch.data());
+            a.normalize();
+            b.normalize();
+            if (m != nullptr)
+            {
+                combine(steps.m00, steps.m01, step, scratch);
+                combine(steps.m10, steps.m11, step, scratch);
+                steps.determinant *= step.odd ? -1 : 1;
+            }
+        }
+        if (m != nullptr)
+        {
+            m->multiply(std::move(steps));
+        }
+    }
+
+    // a = high_a 2^bits + (a mod 2^bits) and the same for b, where (high_a; high_b) = m (reduced high parts):
+    // the matrix is applied to a and b, which become nonnegative and ordered by adjusting the columns of m
+    static void apply_high(big_integer& a, big_integer& b, size_t bits, big_integer& high_a, big_integer& high_b,
+                           matrix& m)
+    {
+        big_integer low_a = low_bits(a, bits);
+        big_integer low_b = low_bits(b, bits);
+        // m^-1 = determinant * (m11 -m01; -m10 m00)
+        bool positive = m.determinant > 0;
+        a = (positive ? m.m11 : m.m01) * (positive ? low_a : low_b);
+        submul(a, positive ? m.m01 : m.m11, positive ? low_b : low_a);
+        b = (positive ? m.m00 : m.m10) * (positive ? low_b : low_a);
+        submul(b, positive ? m.m10 : m.m00, positive ? low_a : low_b);
+        a += high_a << static_cast<int>(bits);
+        b += high_b << static_cast<int>(bits);
+
+        // the low parts may outweigh the reduced high ones
+        if (a.negate_)
+        {
+            a.flip_sign();
+            m.m00.flip_sign();
+            m.m10.flip_sign();
+            m.determinant = -m.determinant;
+        }
+        if (b.negate_)
+        {
+            b.flip_sign();
+            m.m01.flip_sign();
+            m.m11.flip_sign();
+            m.determinant = -m.determinant;
+        }
+        if (a.compare_magnitude(b) < 0)
+        {
+            std::swap(a, b);
+            std::swap(m.m00, m.m01);
+            std::swap(m.m10, m.m11);
+            m.determinant = -m.determinant;
+        }
+    }
+
+    // reduces a >= b until b has about half the bits of a; m, if given, is multiplied by the steps taken
+    static void half_gcd(big_integer& a, big_integer& b, matrix* m)
+    {
+        size_t s = a.bit_length() / 2 + 1;
+        if (b.bit_length() <= s)
+        {
+            return;
+        }
+        if (a.data_.size() < magnitude::division_thresholds().half_gcd)
+        {
+            lehmer(a, b, m, s);
+            return;
+        }
+
+        big_integer high_a = a >> static_cast<int>(s);
+        big_integer high_b = b >> static_cast<int>(s);
+        matrix first;
+        half_gcd(high_a, high_b, &first);
+        apply_high(a, b, s, high_a, high_b, first);
+        if (m != nullptr)
+        {
+            m->multiply(std::move(first));
+        }
+        if (b.bit_length() <= s)
+        {
+            return;
+        }
+        euclid_step(a, b, m);
+        if (b.bit_length() <= s)
+        {
+            return;
+        }
+
+        // the leading 2 (n' - s) bits of the n'-bit a take it to about s bits
+        size_t shift = 2 * s - a.bit_length();
+        high_a = a >> static_cast<int>(shift);
+        high_b = b >> static_cast<int>(shift);
+        matrix second;
+        half_gcd(high_a, high_b, &second);
+        apply_high(a, b, shift, high_a, high_b, second);
+        if (m != nullptr)
+        {
+            m->multiply(std::move(second));
+        }
+    }
+
+    // a = gcd(a, b) for a >= b >= 0, b = 0
+    static void reduce(big_integer& a, big_integer& b, matrix* m)
+    {
+        while (!b.is_zero())
+        {
+            if (b.data_.size() < magnitude::division_thresholds().half_gcd)
+            {
+                if (m != nullptr)
+                {
+                    lehmer(a, b, m, 0);
+                    return;
+                }
+                big_integer::storage g(a.data_.size());
+                g.resize(magnitude::gcd(g.data(), a.data_.data(), a.data_.size(), b.data_.data(), b.data_.size()));
+                a.data_ = std::move(g);
+                b.data_.clear();
+                return;
+            }
+            // a long quotient is cheaper to take by a division
+            size_t a_bits = a.bit_length();
+            if (a_bits - b.bit_length() >= magnitude::LIMB_BITS)
+            {
+                euclid_step(a, b, m);
+                continue;
+            }
+            half_gcd(a, b, m);
+            if (!b.is_zero() && a.bit_length() >= a_bits)
+            {
+                euclid_step(a, b, m);
+            }
+        }
+    }
+};
+
+big_integer gcd(big_integer const& a, big_integer const& b)
+{
+    return gcd_reduction::gcd(a, b);
+}
+
+big_integer lcm(big_integer const& a, big_integer const& b)
+{
+    if (a == 0 || b == 0)
+    {
+        return 0;
+    }
+    big_integer result = a / gcd(a, b) * b;
+    return result < 0 ? -result : result;
+}
+
+big_integer extended_gcd(big_integer const& a, big_integer const& b, big_integer& x, big_integer& y)
+{
+    return gcd_reduction::extended_gcd(a, b, x, y);
+}
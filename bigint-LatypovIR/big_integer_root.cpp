@@ -0,0 +1,94 @@
+#include "big_integer.h"
+
+#include <stdexcept>
+
+// Integer roots by Newton's iteration with precision doubling: the root of the leading half of the bits,
+// shifted into place, is within a unit in its last half, and one or two iterations at full length finish it.
+// The full-length division dominates, so a root costs about as much as a division.
+namespace
+{
+    big_integer power(big_integer base, unsigned exponent)
+    {
+        big_integer result = 1;
+        while (exponent != 0)
+        {
+            if ((exponent & 1) != 0)
+            {
+                result *= base;
+            }
+            exponent >>= 1;
+            if (exponent != 0)
+            {
+                base = square(base);
+            }
+        }
+        return result;
+    }
+
+    big_integer root(big_integer const& a, unsigned k)
+    {
+        size_t bits = a.bit_length();
+        if (bits <= k)
+        {
+            // the root is below 2
+            return a == 0 ? 0 : 1;
+        }
+        // the root has about bits / k bits, the lowest `low` of them are left to the iteration
+        size_t low = bits / (2 * k);
+        big_integer x = low == 0 ? big_integer(1) << static_cast<int>((bits + k - 1) / k)
+                                 : (root(a >> static_cast<int>(k * low), k) + 1) << static_cast<int>(low);
+        // x is above the root, and the iteration decreases it until it reaches the floor of the root
+        while (true)
+        {
+            big_integer y = (big_integer(k - 1) * x + a / power(x, k - 1)) / big_integer(k);
+            if (y >= x)
+            {
+                return x;
+            }
+            x = std::move(y);
+        }
+    }
+}
+
+big_integer isqrt(big_integer const& a)
+{
+    if (a < 0)
+    {
+        throw std::domain_error("square root of a negative number");
+    }
+    size_t bits = a.bit_length();
+    size_t low = bits / 4;
+    if (low == 0)
+    {
+        return a == 0 ? 0 : a < 4 ? 1 : 2;
+    }
+    // s = isqrt(a / 4^low) gives sqrt(a) < (s + 1) 2^low; one iteration from there is off by at most one
+    big_integer x = (isqrt(a >> static_cast<int>(2 * low)) + 1) << static_cast<int>(low);
+    x = (x + a / x) >> 1;
+    if (square(x) > a)
+    {
+        --x;
+    }
+    return x;
+}
+
+big_integer iroot(big_integer const& a, unsigned k)
+{
+    if (k == 0)
+    {
+        throw std::domain_error("zeroth root");
+    }
+    if (k == 1)
+    {
+        return a;
+    }
+    if (a < 0)
+    {
+        if (k % 2 == 0)
+        {
+            throw std::domain_error("even root of a negative number");
+        }
+        return -root(-a, k);
+    }
+    return k == 2 ? isqrt(a) : root(a, k);
+}
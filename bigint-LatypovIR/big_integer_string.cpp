@@ -0,0 +1,283 @@
+#include "big_integer.h"
+#include "magnitude.h"
+#include "parallel.h"
+
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Conversion between big_integer and strings.
+// Decimal digits are grouped into chunks of 9 (19 with 64-bit limbs) digits; long numbers are split in halves
+// at a power 10^(CHUNK_DIGITS * 2^k), which makes both directions as fast as multiplication (and division) up to a log factor.
+// Power-of-two radices map digits to bits directly and take linear time.
+namespace
+{
+    using magnitude::LIMB_BITS;
+    using magnitude::limb_t;
+    using magnitude::double_limb_t;
+
+    // the largest power of ten that fits in a limb
+#if BIGINT_LIMB_BITS == 64
+    limb_t constexpr CHUNK = 10000000000000000000ULL;
+    size_t constexpr CHUNK_DIGITS = 19;
+#else
+    limb_t constexpr CHUNK = 1000000000;
+    size_t constexpr CHUNK_DIGITS = 9;
+#endif
+
+    // numbers with at most that many digits are parsed chunk by chunk
+    size_t constexpr PARSE_BASECASE_DIGITS = 2000;
+    // numbers with at most that many limbs are printed chunk by chunk
+    size_t constexpr PRINT_BASECASE_LIMBS = 60;
+
+    char const DIGITS[] = "0123456789abcdefghijklmnopqrstuv";
+
+    uint32_t digit_value(char c)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'z')
+        {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'Z')
+        {
+            return c - 'A' + 10;
+        }
+        return UINT32_MAX;
+    }
+
+    // bits per digit of a power-of-two radix
+    unsigned radix_bits(int radix)
+    {
+        for (unsigned bits = 1; bits <= 5; ++bits)
+        {
+            if (radix == 1 << bits)
+            {
+                return bits;
+            }
+        }
+        throw std::invalid_argument("unsupported radix " + std::to_string(radix));
+    }
+}
+
+big_integer::big_integer(std::string const& str) : big_integer(str, 10) {}
+
+big_integer::big_integer(std::string const& str, int radix) : big_integer()
+{
+    unsigned bits = radix == 10 ? 0 : radix_bits(radix);
+
+    size_t start = !str.empty() && (str[0] == '-' || str[0] == '+') ? 1 : 0;
+    if (start == str.length())
+    {
+        throw std::invalid_argument(str);
+    }
+    for (size_t i = start; i < str.length(); ++i)
+    {
+        if (digit_value(str[i]) >= static_cast<uint32_t>(radix))
+        {
+            throw std::invalid_argument(str);
+        }
+    }
+
+    char const* first = str.data() + start;
+    char const* last = str.data() + str.length();
+    if (bits == 0)
+    {
+        from_decimal(first, last);
+    }
+    else
+    {
+        data_.assign(((last - first) * bits + LIMB_BITS - 1) / LIMB_BITS, 0);
+        size_t bit = 0;
+        for (char const* p = last; p != first; bit += bits)
+        {
+            limb_t digit = digit_value(*--p);
+            size_t offset = bit % LIMB_BITS;
+            data_[bit / LIMB_BITS] |= digit << offset;
+            if (offset + bits > LIMB_BITS)
+            {
+                data_[bit / LIMB_BITS + 1] |= digit >> (LIMB_BITS - offset);
+            }
+        }
+        normalize();
+    }
+    negate_ = str[0] == '-' && !is_zero();
+}
+
+std::string to_string(big_integer const& a)
+{
+    if (a.is_zero())
+    {
+        return "0";
+    }
+    std::string result = a.negate_ ? "-" : "";
+    (a.negate_ ? -a : a).to_decimal(result, 0);
+    return result;
+}
+
+std::string to_string(big_integer const& a, int radix)
+{
+    if (radix == 10)
+    {
+        return to_string(a);
+    }
+    unsigned bits = radix_bits(radix);
+    if (a.is_zero())
+    {
+        return "0";
+    }
+
+    size_t digits = (a.bit_length() + bits - 1) / bits;
+
+    std::string result = a.negate_ ? "-" : "";
+    result.reserve(result.size() + digits);
+    for (size_t i = digits; i != 0;)
+    {
+        --i;
+        size_t bit = i * bits;
+        size_t index = bit / LIMB_BITS;
+        size_t offset = bit % LIMB_BITS;
+        limb_t digit = a.data_[index] >> offset;
+        if (offset + bits > LIMB_BITS && index + 1 < a.data_.size())
+        {
+            digit |= a.data_[index + 1] << (LIMB_BITS - offset);
+        }
+        result += DIGITS[digit & (radix - 1)];
+    }
+    return result;
+}
+
+big_integer const& big_integer::decimal_power(size_t level)
+{
+    // a deque keeps references to computed powers valid while it grows; the lock makes conversions thread-safe
+    static std::deque<big_integer> powers{big_integer(CHUNK)};
+    static std::mutex mutex;
+    std::unique_lock<std::mutex> lock(mutex);
+    // the cache outlives any resource the caller may have set
+    magnitude::scoped_limb_resource default_resource(magnitude::default_limb_resource());
+    while (powers.size() <= level)
+    {
+        // squaring may fork and help with other threads' tasks, which may need the lock: it is released meanwhile
+        size_t next = powers.size();
+        big_integer const& last = powers.back();
+        lock.unlock();
+        big_integer power = square(last);
+        lock.lock();
+        if (powers.size() == next)
+        {
+            powers.push_back(std::move(power));
+        }
+    }
+    return powers[level];
+}
+
+void big_integer::from_decimal(char const* first, char const* last)
+{
+    size_t digits = last - first;
+    if (digits > PARSE_BASECASE_DIGITS)
+    {
+        // low part gets CHUNK_DIGITS * 2^level digits, the high part at most as many
+        size_t level = 0;
+        while (CHUNK_DIGITS << (level + 1) < digits)
+        {
+            ++level;
+        }
+        char const* middle = last - (CHUNK_DIGITS << level);
+
+        // the halves are independent
+        big_integer high;
+        magnitude::fork_join(
+            digits / CHUNK_DIGITS, [&] { high.from_decimal(first, middle); }, [&] { from_decimal(middle, last); });
+        high *= decimal_power(level);
+        *this += high;
+        return;
+    }
+
+    data_.clear();
+    data_.reserve(digits / CHUNK_DIGITS + 1);
+    size_t head = digits % CHUNK_DIGITS == 0 ? CHUNK_DIGITS : digits % CHUNK_DIGITS;
+    for (char const* p = first; p != last; head = CHUNK_DIGITS)
+    {
+        limb_t chunk = 0;
+        limb_t scale = 1;
+        for (size_t i = 0; i < head; ++i, ++p)
+        {
+            chunk = chunk * 10 + (*p - '0');
+            scale *= 10;
+        }
+        // data_ = data_ * scale + chunk
+        double_limb_t carry = chunk;
+        for (limb_t& limb : data_)
+        {
+            carry += static_cast<double_limb_t>(limb) * scale;
+            limb = static_cast<limb_t>(carry);
+            carry >>= LIMB_BITS;
+        }
+        if (carry != 0)
+        {
+            data_.push_back(static_cast<limb_t>(carry));
+        }
+    }
+    negate_ = false;
+    normalize();
+}
+
+void big_integer::to_decimal(std::string& out, size_t width) const
+{
+    if (data_.size() > PRINT_BASECASE_LIMBS)
+    {
+        // the largest cached power with less than half of the limbs, so that the quotient is not zero
+        size_t level = 0;
+        while (2 * decimal_power(level + 1).data_.size() < data_.size())
+        {
+            ++level;
+        }
+        big_integer const& power = decimal_power(level);
+        size_t low_digits = CHUNK_DIGITS << level;
+
+        std::pair<big_integer, big_integer> halves = divmod(*this, power);
+        // the low half is printed into its own string, so that both can be printed at once
+        std::string low;
+        magnitude::fork_join(
+            data_.size(), [&] { halves.second.to_decimal(low, low_digits); },
+            [&] { halves.first.to_decimal(out, width > low_digits ? width - low_digits : 0); });
+        out += low;
+        return;
+    }
+
+    // repeated division by CHUNK through its precomputed reciprocal
+    static magnitude::limb_divisor const chunk_divisor(CHUNK);
+    std::vector<limb_t> chunks;
+    storage x = data_;
+    while (!x.empty())
+    {
+        chunks.push_back(magnitude::divmod_1(x.data(), x.data(), x.size(), chunk_divisor));
+        if (x.back() == 0)
+        {
+            x.pop_back();
+        }
+    }
+
+    std::string digits;
+    for (size_t i = chunks.size(); i != 0;)
+    {
+        --i;
+        std::string chunk = std::to_string(chunks[i]);
+        if (i + 1 != chunks.size())
+        {
+            digits.append(CHUNK_DIGITS - chunk.size(), '0');
+        }
+        digits += chunk;
+    }
+    if (width > digits.size())
+    {
+        out.append(width - digits.size(), '0');
+    }
+    out += digits;
+}
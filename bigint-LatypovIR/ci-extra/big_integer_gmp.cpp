@@ -225,6 +225,71 @@ bool operator>=(big_integer_gmp const& a, big_integer_gmp const& b)
     return mpz_cmp(a.mpz, b.mpz) >= 0;
 }
 
+big_integer_gmp pow_mod(big_integer_gmp const& base, big_integer_gmp const& exponent, big_integer_gmp const& modulus)
+{
+    big_integer_gmp result;
+    mpz_powm(result.mpz, base.mpz, exponent.mpz, modulus.mpz);
+    return result;
+}
+
+big_integer_gmp isqrt(big_integer_gmp const& a)
+{
+    big_integer_gmp result;
+    mpz_sqrt(result.mpz, a.mpz);
+    return result;
+}
+
+big_integer_gmp iroot(big_integer_gmp const& a, unsigned k)
+{
+    big_integer_gmp result;
+    mpz_root(result.mpz, a.mpz, k);
+    return result;
+}
+
+big_integer_gmp gcd(big_integer_gmp const& a, big_integer_gmp const& b)
+{
+    big_integer_gmp result;
+    mpz_gcd(result.mpz, a.mpz, b.mpz);
+    return result;
+}
+
+big_integer_gmp extended_gcd(big_integer_gmp const& a, big_integer_gmp const& b, big_integer_gmp& x, big_integer_gmp& y)
+{
+    big_integer_gmp result;
+    mpz_gcdext(result.mpz, x.mpz, y.mpz, a.mpz, b.mpz);
+    return result;
+}
+
+big_integer_gmp big_integer_gmp::factorial(unsigned long n)
+{
+    big_integer_gmp result;
+    mpz_fac_ui(result.mpz, n);
+    return result;
+}
+
+big_integer_gmp big_integer_gmp::binomial(unsigned long n, unsigned long k)
+{
+    big_integer_gmp result;
+    mpz_bin_uiui(result.mpz, n, k);
+    return result;
+}
+
+std::vector<unsigned char> to_bytes(big_integer_gmp const& a)
+{
+    std::vector<unsigned char> result((mpz_sizeinbase(a.mpz, 2) + 7) / 8);
+    size_t count = 0;
+    mpz_export(result.data(), &count, 1, 1, 1, 0, a.mpz);
+    result.resize(count);
+    return result;
+}
+
+big_integer_gmp big_integer_gmp::from_bytes(unsigned char const* bytes, size_t size)
+{
+    big_integer_gmp result;
+    mpz_import(result.mpz, size, 1, 1, 1, 0, bytes);
+    return result;
+}
+
 std::string to_string(big_integer_gmp const& a)
 {
     char* tmp = mpz_get_str(nullptr, 10, a.mpz);
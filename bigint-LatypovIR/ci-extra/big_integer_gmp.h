@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <gmp.h>
 #include <iosfwd>
+#include <vector>
 
 struct big_integer_gmp
 {
@@ -60,6 +61,19 @@ struct big_integer_gmp
     friend bool operator>=(big_integer_gmp const& a, big_integer_gmp const& b);
 
     friend std::string to_string(big_integer_gmp const& a);
+    // base^exponent mod modulus, exponent >= 0
+    friend big_integer_gmp pow_mod(big_integer_gmp const& base, big_integer_gmp const& exponent,
+                                   big_integer_gmp const& modulus);
+    friend big_integer_gmp isqrt(big_integer_gmp const& a);
+    friend big_integer_gmp iroot(big_integer_gmp const& a, unsigned k);
+    friend big_integer_gmp gcd(big_integer_gmp const& a, big_integer_gmp const& b);
+    friend big_integer_gmp extended_gcd(big_integer_gmp const& a, big_integer_gmp const& b, big_integer_gmp& x,
+                                        big_integer_gmp& y);
+    static big_integer_gmp factorial(unsigned long n);
+    static big_integer_gmp binomial(unsigned long n, unsigned long k);
+    // magnitude as big-endian bytes, as mpz_export and mpz_import with the most significant byte first
+    friend std::vector<unsigned char> to_bytes(big_integer_gmp const& a);
+    static big_integer_gmp from_bytes(unsigned char const* bytes, size_t size);
 
 private:
     mpz_t mpz;
@@ -85,5 +99,12 @@ bool operator>(big_integer_gmp const& a, big_integer_gmp const& b);
 bool operator<=(big_integer_gmp const& a, big_integer_gmp const& b);
 bool operator>=(big_integer_gmp const& a, big_integer_gmp const& b);
 
+big_integer_gmp pow_mod(big_integer_gmp const& base, big_integer_gmp const& exponent, big_integer_gmp const& modulus);
+big_integer_gmp isqrt(big_integer_gmp const& a);
+big_integer_gmp iroot(big_integer_gmp const& a, unsigned k);
+big_integer_gmp gcd(big_integer_gmp const& a, big_integer_gmp const& b);
+big_integer_gmp extended_gcd(big_integer_gmp const& a, big_integer_gmp const& b, big_integer_gmp& x, big_integer_gmp& y);
+std::vector<unsigned char> to_bytes(big_integer_gmp const& a);
+
 std::string to_string(big_integer_gmp const& a);
 std::ostream& operator<<(std::ostream& s, big_integer_gmp const& a);
@@ -7,6 +7,9 @@
 #include <gtest/gtest.h>
 
 #include "../big_integer.h"
+#include "../combinatorics.h"
+#include "../magnitude.h"
+#include "../modular.h"
 #include "big_integer_gmp.h"
 
 namespace
@@ -207,6 +210,106 @@ TEST(correctness_random, mul)
     }
 }
 
+TEST(correctness_random, mul_large)
+{
+    std::default_random_engine rng(42);
+    for (size_t size : {MAX_SIZE * 2, MAX_SIZE * 8, MAX_SIZE * 16})
+    {
+        big_integer_gmp a, b;
+        a.random(size, rng);
+        b.random(size, rng);
+        big_integer A = big_integer(to_string(a));
+        big_integer B = big_integer(to_string(b));
+        EXPECT_EQ(to_string(a * b), to_string(A * B));
+
+        b.random(size / 3, rng);
+        B = big_integer(to_string(b));
+        EXPECT_EQ(to_string(a * b), to_string(A * B));
+    }
+}
+
+TEST(correctness_random, mul_ntt)
+{
+    magnitude::mul_thresholds saved = magnitude::thresholds();
+    magnitude::thresholds().ntt = 64;
+
+    std::default_random_engine rng(42);
+    for (size_t size : {MAX_SIZE * 2, MAX_SIZE * 16})
+    {
+        big_integer_gmp a, b;
+        a.random(size, rng);
+        b.random(size / 2, rng);
+        big_integer A = big_integer(to_string(a));
+        big_integer B = big_integer(to_string(b));
+        EXPECT_EQ(to_string(a * b), to_string(A * B));
+        EXPECT_EQ(to_string(a * a), to_string(square(A)));
+        EXPECT_EQ(to_string(a * a), to_string(A * A));
+    }
+
+    magnitude::thresholds() = saved;
+}
+
+TEST(correctness_random, string_conv_large)
+{
+    std::default_random_engine rng(42);
+    for (size_t size : {MAX_SIZE * 4, MAX_SIZE * 32, MAX_SIZE * 64})
+    {
+        big_integer_gmp a;
+        a.random(size, rng);
+        std::string decimal = to_string(-a);
+        big_integer A(decimal);
+        EXPECT_EQ(decimal, to_string(A));
+
+        std::string hex = to_string(A, 16);
+        EXPECT_EQ(decimal, to_string(big_integer(hex, 16)));
+        EXPECT_EQ(hex, to_string(big_integer(to_string(A, 2), 2), 16));
+    }
+}
+
+TEST(correctness_random, binary_conv)
+{
+    std::default_random_engine rng(42);
+    for (size_t size : {size_t(1), size_t(3), size_t(64), MAX_SIZE * 4, MAX_SIZE * 32})
+    {
+        big_integer_gmp a;
+        a.random(size, rng);
+        // the bytes hold the magnitude, the sign is passed separately
+        std::vector<unsigned char> bytes = to_bytes(a);
+        big_integer A(bytes.data(), bytes.size(), byte_order::big_endian, a < 0);
+        EXPECT_EQ(to_string(a), to_string(A));
+        EXPECT_EQ(bytes, to_bytes(A, byte_order::big_endian));
+        EXPECT_EQ(std::vector<unsigned char>(bytes.rbegin(), bytes.rend()), to_bytes(A, byte_order::little_endian));
+
+        std::vector<uint32_t> words = to_words(A);
+        EXPECT_EQ(A, big_integer(words.data(), words.size(), A < 0));
+        EXPECT_EQ(a < 0 ? -a : a, big_integer_gmp::from_bytes(bytes.data(), bytes.size()));
+    }
+}
+
+TEST(correctness_random, addmul)
+{
+    std::default_random_engine rng(322);
+    for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn)
+    {
+        // the operand sizes cross the row-by-row limit of the fused kernel
+        for (size_t size : {size_t(100), MAX_SIZE, 4 * MAX_SIZE})
+        {
+            big_integer_gmp acc, a, b;
+            acc.random(size * (itn % 3 + 1), rng);
+            a.random(size, rng);
+            b.random(size / (itn % 4 + 1), rng);
+            big_integer ACC = big_integer(to_string(acc));
+            big_integer A = big_integer(to_string(a));
+            big_integer B = big_integer(to_string(b));
+            addmul(ACC, A, B);
+            EXPECT_EQ(to_string(acc + a * b), to_string(ACC));
+            submul(ACC, B, A);
+            submul(ACC, A, B);
+            EXPECT_EQ(to_string(acc - a * b), to_string(ACC));
+        }
+    }
+}
+
 TEST(correctness_random, div)
 {
     std::default_random_engine rng(322);
@@ -243,6 +346,135 @@ TEST(correctness_random, mod)
     }
 }
 
+TEST(correctness_random, divmod_large)
+{
+    magnitude::div_thresholds saved = magnitude::division_thresholds();
+
+    std::default_random_engine rng(322);
+    for (size_t threshold : {size_t(8), saved.burnikel_ziegler})
+    {
+        magnitude::division_thresholds().burnikel_ziegler = threshold;
+        for (size_t size : {MAX_SIZE * 4, MAX_SIZE * 32})
+        {
+            for (size_t divisor_size : {size / 2 + 7, size / 5, size - 100})
+            {
+                big_integer_gmp a, b;
+                a.random(size, rng);
+                b.random(divisor_size, rng);
+                big_integer A = big_integer(to_string(a));
+                big_integer B = big_integer(to_string(-b));
+                EXPECT_EQ(to_string(a / -b), to_string(A / B));
+                EXPECT_EQ(to_string(a % -b), to_string(A % B));
+            }
+        }
+    }
+
+    magnitude::division_thresholds() = saved;
+}
+
+TEST(correctness_random, pow_mod)
+{
+    std::default_random_engine rng(322);
+    for (size_t bits : {size_t(31), size_t(64), size_t(1024), size_t(2048)})
+    {
+        for (size_t itn = 0; itn != 4; ++itn)
+        {
+            big_integer_gmp a, e, m;
+            a.random(bits + 40, rng);
+            e.random(bits, rng);
+            m.random(bits, rng);
+            if (e < 0)
+            {
+                e = -e;
+            }
+            if (m < 0)
+            {
+                m = -m;
+            }
+            // odd moduli go through Montgomery reduction, even ones through division
+            m += itn % 2 == 0 ? m % 2 + 1 : m % 2 + 2;
+            modular_context context{big_integer(to_string(m))};
+            big_integer A = big_integer(to_string(a));
+            EXPECT_EQ(to_string(pow_mod(a % m + m, e, m)), to_string(context.pow_mod(A, big_integer(to_string(e)))));
+            EXPECT_EQ(to_string((a * a % m + m) % m), to_string(context.mul_mod(A, A)));
+        }
+    }
+}
+
+TEST(correctness_random, factorial_binomial)
+{
+    std::default_random_engine rng(7);
+    for (unsigned long n : {100UL, 5000UL, 30000UL})
+    {
+        EXPECT_EQ(to_string(big_integer_gmp::factorial(n)), to_string(factorial(n)));
+        unsigned long k = std::uniform_int_distribution<unsigned long>(0, n)(rng);
+        EXPECT_EQ(to_string(big_integer_gmp::binomial(n, k)), to_string(binomial(n, k)));
+    }
+
+    // the product tree split between threads
+    magnitude::parallel_settings saved = magnitude::parallel_execution();
+    magnitude::parallel_execution().threads = 4;
+    magnitude::parallel_execution().threshold = 16;
+    EXPECT_EQ(to_string(big_integer_gmp::factorial(30000)), to_string(factorial(30000)));
+    magnitude::parallel_execution() = saved;
+}
+
+TEST(correctness_random, roots)
+{
+    std::default_random_engine rng(11);
+    for (size_t bits : {size_t(10), size_t(100), size_t(1000), size_t(20000)})
+    {
+        for (size_t itn = 0; itn != 4; ++itn)
+        {
+            big_integer_gmp a;
+            a.random(bits, rng);
+            if (a < 0)
+            {
+                a = -a;
+            }
+            big_integer A(to_string(a));
+            EXPECT_EQ(to_string(isqrt(a)), to_string(isqrt(A)));
+            for (unsigned k : {3U, 5U, 16U})
+            {
+                EXPECT_EQ(to_string(iroot(a, k)), to_string(iroot(A, k)));
+            }
+        }
+    }
+}
+
+TEST(correctness_random, gcd)
+{
+    std::default_random_engine rng(13);
+    magnitude::div_thresholds saved = magnitude::division_thresholds();
+    // the recursion from a few limbs on, and the default
+    for (size_t threshold : {size_t(3), saved.half_gcd})
+    {
+        magnitude::division_thresholds().half_gcd = threshold;
+        for (size_t bits : {size_t(50), size_t(3000), size_t(30000)})
+        {
+            for (size_t itn = 0; itn != 4; ++itn)
+            {
+                // a common factor and unbalanced operands
+                big_integer_gmp a, b, c;
+                a.random(bits, rng);
+                b.random(itn % 2 == 0 ? bits : bits / 3, rng);
+                c.random(bits / 4, rng);
+                a *= c;
+                b *= c;
+                big_integer A(to_string(a));
+                big_integer B(to_string(b));
+                EXPECT_EQ(to_string(gcd(a, b)), to_string(gcd(A, B)));
+                big_integer x, y;
+                big_integer g = extended_gcd(A, B, x, y);
+                EXPECT_EQ(to_string(gcd(a, b)), to_string(g));
+                EXPECT_EQ(g, A * x + B * y);
+                EXPECT_LE(x < 0 ? -x : x, (B < 0 ? -B : B) / (2 * g));
+            }
+        }
+    }
+    magnitude::division_thresholds() = saved;
+}
+
 TEST(correctness_random, bitwise)
 {
     std::default_random_engine rng(42);
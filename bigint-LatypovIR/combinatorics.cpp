@@ -0,0 +1,143 @@
+#include "combinatorics.h"
+
+#include <algorithm>
+#include <bitset>
+#include <limits>
+
+namespace
+{
+    // binomials with k up to this are computed by a division by k!, as are those with n beyond the prime sieve
+    uint64_t constexpr SMALL_BINOMIAL = 64;
+    uint64_t constexpr SIEVE_LIMIT = uint64_t(1) << 26;
+
+    // product of values[0..n), which are consumed
+    big_integer product_tree(big_integer* values, size_t n)
+    {
+        if (n == 1)
+        {
+            return std::move(values[0]);
+        }
+        size_t half = n / 2;
+        big_integer low;
+        big_integer high;
+        // the values are at least a limb long, as in the packed ranges below
+        magnitude::fork_join(
+            n, [&] { high = product_tree(values + half, n - half); }, [&] { low = product_tree(values, half); });
+        return std::move(low) * std::move(high);
+    }
+
+    // appends first, first + step, ..., up to last, multiplied together into words as long as they fit,
+    // so the product tree starts from full words instead of small numbers
+    void pack(std::vector<big_integer>& out, uint64_t first, uint64_t last, uint64_t step)
+    {
+        uint64_t word = 1;
+        for (uint64_t k = first; k <= last; k += step)
+        {
+            if (word > std::numeric_limits<uint64_t>::max() / k)
+            {
+                out.emplace_back(word);
+                word = 1;
+            }
+            word *= k;
+            if (last - k < step)
+            {
+                break;
+            }
+        }
+        out.emplace_back(word);
+    }
+
+    // product of the odd numbers in [first, last]
+    big_integer odd_product(uint64_t first, uint64_t last)
+    {
+        first |= 1;
+        if (first > last)
+        {
+            return 1;
+        }
+        std::vector<big_integer> values;
+        pack(values, first, last, 2);
+        return product(std::move(values));
+    }
+}
+
+big_integer product(std::vector<big_integer> values)
+{
+    if (values.empty())
+    {
+        return 1;
+    }
+    return product_tree(values.data(), values.size());
+}
+
+big_integer factorial(uint64_t n)
+{
+    // n! = 2^(n - popcount(n)) * prod_{i >= 0} (product of the odd numbers up to n >> i); going down the levels,
+    // odd is extended by the odd numbers in (n >> (i + 1), n >> i] only
+    big_integer odd = 1;
+    big_integer result = 1;
+    for (int i = 63; i >= 0; --i)
+    {
+        uint64_t high = n >> i;
+        if (high < 3)
+        {
+            continue;
+        }
+        odd *= odd_product((high >> 1) + 1, high);
+        result *= odd;
+    }
+    return result << static_cast<int>(n - std::bitset<64>(n).count());
+}
+
+big_integer binomial(uint64_t n, uint64_t k)
+{
+    if (k > n)
+    {
+        return 0;
+    }
+    k = std::min(k, n - k);
+    if (k == 0)
+    {
+        return 1;
+    }
+    if (k <= SMALL_BINOMIAL || n > SIEVE_LIMIT)
+    {
+        // n (n - 1) ... (n - k + 1) / k!, the division is exact
+        std::vector<big_integer> values;
+        pack(values, n - k + 1, n, 1);
+        return product(std::move(values)) / factorial(k);
+    }
+    // by Kummer's theorem, the exponent of a prime p is the number of borrows when subtracting k from n in base p,
+    // and p to that power is at most n
+    std::vector<bool> composite(n + 1);
+    std::vector<big_integer> powers;
+    uint64_t word = 1;
+    for (uint64_t p = 2; p <= n; ++p)
+    {
+        if (composite[p])
+        {
+            continue;
+        }
+        for (uint64_t multiple = p * p; multiple <= n; multiple += p)
+        {
+            composite[multiple] = true;
+        }
+        uint64_t factor = 1;
+        for (uint64_t m = n, j = k, borrow = 0; m != 0; m /= p, j /= p)
+        {
+            borrow = m % p < j % p + borrow ? 1 : 0;
+            if (borrow != 0)
+            {
+                factor *= p;
+            }
+        }
+        if (word > std::numeric_limits<uint64_t>::max() / factor)
+        {
+            powers.emplace_back(word);
+            word = 1;
+        }
+        word *= factor;
+    }
+    powers.emplace_back(word);
+    return product(std::move(powers));
+}
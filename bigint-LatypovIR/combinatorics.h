@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "big_integer.h"
+#include "parallel.h"
+
+// Products of many factors, computed by balanced product trees: the operands of each multiplication
+// have similar lengths, so fast multiplication applies, instead of the quadratic cost of a running product.
+// Long trees share their subtrees between threads, see magnitude::parallel_execution().
+
+// product of values, 1 for none
+big_integer product(std::vector<big_integer> values);
+
+template <typename InputIt>
+big_integer product(InputIt first, InputIt last)
+{
+    return product(std::vector<big_integer>(first, last));
+}
+
+big_integer factorial(uint64_t n);
+// n choose k, 0 for k > n
+big_integer binomial(uint64_t n, uint64_t k);
+
+// term k of a series sum_k a(k) * p(first) ... p(k) / (q(first) ... q(k))
+struct series_term
+{
+    big_integer p;
+    big_integer q;
+    big_integer a;
+};
+
+// terms [first, last) combined: p and q are the products of p(k) and q(k), the sum of the terms is t / q
+struct series_sum
+{
+    big_integer p;
+    big_integer q;
+    big_integer t;
+};
+
+// sums term(first), ..., term(last - 1), first < last, by binary splitting: the halves are summed recursively
+// and combined as P = P1 P2, Q = Q1 Q2, T = T1 Q2 + P1 T2; term may be called concurrently
+template <typename Term>
+series_sum binary_splitting(uint64_t first, uint64_t last, Term const& term)
+{
+    if (last - first == 1)
+    {
+        series_term x = term(first);
+        series_sum result{std::move(x.p), std::move(x.q), big_integer()};
+        result.t = x.a * result.p;
+        return result;
+    }
+    uint64_t middle = first + (last - first) / 2;
+    series_sum low;
+    series_sum high;
+    // every term adds at least a limb to the products
+    magnitude::fork_join(
+        last - first, [&] { high = binary_splitting(middle, last, term); },
+        [&] { low = binary_splitting(first, middle, term); });
+    series_sum result;
+    result.t = low.t * high.q;
+    addmul(result.t, low.p, high.t);
+    result.p = std::move(low.p) * std::move(high.p);
+    result.q = std::move(low.q) * std::move(high.q);
+    return result;
+}
@@ -0,0 +1,146 @@
+#include "limb_memory.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+namespace magnitude
+{
+    namespace
+    {
+        // a heap buffer starts with the resource it came from, padded to whole limbs
+        size_t constexpr HEADER_LIMBS = (sizeof(limb_resource*) + sizeof(limb_t) - 1) / sizeof(limb_t);
+
+        // scratch blocks are aligned to this, the first chunk is at least that large, and at most that much
+        // scratch memory is kept by a thread between computations
+        size_t constexpr SCRATCH_ALIGNMENT = alignof(std::max_align_t);
+        size_t constexpr MIN_CHUNK = size_t(1) << 16;
+        size_t constexpr MAX_KEPT = size_t(1) << 24;
+
+        struct new_delete_resource : limb_resource
+        {
+            limb_t* allocate(size_t n) override
+            {
+                return new limb_t[n];
+            }
+
+            void deallocate(limb_t* p, size_t) noexcept override
+            {
+                delete[] p;
+            }
+        };
+
+        thread_local limb_resource* current_resource = nullptr;
+    }
+
+    limb_resource* default_limb_resource() noexcept
+    {
+        static new_delete_resource instance;
+        return &instance;
+    }
+
+    limb_resource* current_limb_resource() noexcept
+    {
+        return current_resource != nullptr ? current_resource : default_limb_resource();
+    }
+
+    limb_resource* set_limb_resource(limb_resource* resource) noexcept
+    {
+        limb_resource* previous = current_limb_resource();
+        current_resource = resource;
+        return previous;
+    }
+
+    limb_t* allocate_limbs(size_t n)
+    {
+        limb_resource* resource = current_limb_resource();
+        limb_t* block = resource->allocate(n + HEADER_LIMBS);
+        std::memcpy(block, &resource, sizeof(resource));
+        return block + HEADER_LIMBS;
+    }
+
+    void deallocate_limbs(limb_t* p, size_t n) noexcept
+    {
+        limb_t* block = p - HEADER_LIMBS;
+        limb_resource* resource;
+        std::memcpy(&resource, block, sizeof(resource));
+        resource->deallocate(block, n + HEADER_LIMBS);
+    }
+
+    scratch_arena::~scratch_arena()
+    {
+        for (chunk& c : chunks_)
+        {
+            delete[] c.data;
+        }
+    }
+
+    void* scratch_arena::allocate(size_t bytes)
+    {
+        assert(depth_ != 0);
+        bytes = (bytes + SCRATCH_ALIGNMENT - 1) / SCRATCH_ALIGNMENT * SCRATCH_ALIGNMENT;
+        if (!chunks_.empty() && chunks_[current_].size - used_ >= bytes)
+        {
+            void* result = chunks_[current_].data + used_;
+            used_ += bytes;
+            return result;
+        }
+        // the chunks after the current one are free, the first large enough is taken
+        size_t next = chunks_.empty() ? 0 : current_ + 1;
+        while (next < chunks_.size() && chunks_[next].size < bytes)
+        {
+            ++next;
+        }
+        if (next == chunks_.size())
+        {
+            size_t size = std::max({bytes, MIN_CHUNK, chunks_.empty() ? 0 : 2 * chunks_.back().size});
+            chunks_.push_back({new unsigned char[size], size});
+        }
+        current_ = next;
+        used_ = bytes;
+        return chunks_[current_].data;
+    }
+
+    void scratch_arena::shrink()
+    {
+        if (chunks_.empty() || (chunks_.size() == 1 && chunks_[0].size <= MAX_KEPT))
+        {
+            return;
+        }
+        size_t total = 0;
+        for (chunk& c : chunks_)
+        {
+            total += c.size;
+            delete[] c.data;
+        }
+        chunks_.clear();
+        if (total <= MAX_KEPT)
+        {
+            chunks_.push_back({new unsigned char[total], total});
+        }
+    }
+
+    scratch_arena& scratch()
+    {
+        thread_local scratch_arena instance;
+        return instance;
+    }
+
+    scratch_frame::scratch_frame() : arena_(scratch()), chunk_(arena_.current_), used_(arena_.used_)
+    {
+        ++arena_.depth_;
+    }
+
+    scratch_frame::~scratch_frame()
+    {
+        arena_.current_ = chunk_;
+        arena_.used_ = used_;
+        if (--arena_.depth_ == 0)
+        {
+            arena_.shrink();
+            arena_.current_ = 0;
+            arena_.used_ = 0;
+        }
+    }
+}
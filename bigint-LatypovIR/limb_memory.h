@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "magnitude.h"
+
+// Memory for limbs: a replaceable resource for the heap buffers of numbers, and a per-thread stack of scratch
+// memory for the temporaries of the kernels.
+namespace magnitude
+{
+    // Source of heap limb buffers, like std::pmr::memory_resource. Each buffer remembers its resource and goes
+    // back to it wherever it is freed, so a resource has to outlive the buffers it gave out and, if numbers
+    // are shared between threads, be thread-safe.
+    struct limb_resource
+    {
+        virtual ~limb_resource() = default;
+        virtual limb_t* allocate(size_t n) = 0;
+        virtual void deallocate(limb_t* p, size_t n) noexcept = 0;
+    };
+
+    // operator new and operator delete
+    limb_resource* default_limb_resource() noexcept;
+    // the resource for new buffers of the calling thread, the default one initially; set returns the previous one
+    limb_resource* current_limb_resource() noexcept;
+    limb_resource* set_limb_resource(limb_resource* resource) noexcept;
+
+    // n limbs from the current resource, and back to the resource they came from
+    limb_t* allocate_limbs(size_t n);
+    void deallocate_limbs(limb_t* p, size_t n) noexcept;
+
+    // the calling thread allocates from resource while the object lives
+    struct scoped_limb_resource
+    {
+        explicit scoped_limb_resource(limb_resource* resource) : previous_(set_limb_resource(resource)) {}
+
+        scoped_limb_resource(scoped_limb_resource const&) = delete;
+        scoped_limb_resource& operator=(scoped_limb_resource const&) = delete;
+
+        ~scoped_limb_resource()
+        {
+            set_limb_resource(previous_);
+        }
+
+    private:
+        limb_resource* previous_;
+    };
+
+    // stateless allocator of number storage over the current limb resource
+    template <typename T>
+    struct limb_allocator
+    {
+        static_assert(sizeof(T) == sizeof(limb_t), "limb_allocator allocates limbs");
+
+        using value_type = T;
+
+        limb_allocator() noexcept = default;
+        template <typename U>
+        limb_allocator(limb_allocator<U> const&) noexcept
+        {
+        }
+
+        T* allocate(size_t n)
+        {
+            return reinterpret_cast<T*>(allocate_limbs(n));
+        }
+
+        void deallocate(T* p, size_t n) noexcept
+        {
+            deallocate_limbs(reinterpret_cast<limb_t*>(p), n);
+        }
+
+        friend bool operator==(limb_allocator const&, limb_allocator const&) noexcept
+        {
+            return true;
+        }
+
+        friend bool operator!=(limb_allocator const&, limb_allocator const&) noexcept
+        {
+            return false;
+        }
+    };
+
+    // Per-thread stack of scratch memory. A scratch_frame marks the top of the stack and releases everything
+    // allocated after it when it ends, so a temporary costs a pointer bump. Blocks are not freed one by one;
+    // a block must not outlive its frame, nor be handed to another thread that keeps it: forked tasks write
+    // into memory that the forking thread allocated.
+    struct scratch_arena
+    {
+        scratch_arena() = default;
+        scratch_arena(scratch_arena const&) = delete;
+        scratch_arena& operator=(scratch_arena const&) = delete;
+        ~scratch_arena();
+
+        // aligned for any limb type; only inside a frame
+        void* allocate(size_t bytes);
+
+    private:
+        friend struct scratch_frame;
+
+        struct chunk
+        {
+            unsigned char* data;
+            size_t size;
+        };
+
+        std::vector<chunk> chunks_;
+        size_t current_ = 0;
+        size_t used_ = 0;
+        size_t depth_ = 0;
+
+        // keeps at most one chunk of all the memory needed so far, but no more than that many bytes
+        void shrink();
+    };
+
+    // the arena of the calling thread
+    scratch_arena& scratch();
+
+    struct scratch_frame
+    {
+        scratch_frame();
+        scratch_frame(scratch_frame const&) = delete;
+        scratch_frame& operator=(scratch_frame const&) = delete;
+        ~scratch_frame();
+
+    private:
+        scratch_arena& arena_;
+        size_t chunk_;
+        size_t used_;
+    };
+
+    // allocator over the arena of the allocating thread; deallocation waits for the frame to end
+    template <typename T>
+    struct scratch_allocator
+    {
+        using value_type = T;
+
+        scratch_allocator() noexcept = default;
+        template <typename U>
+        scratch_allocator(scratch_allocator<U> const&) noexcept
+        {
+        }
+
+        T* allocate(size_t n)
+        {
+            return static_cast<T*>(scratch().allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T*, size_t) noexcept {}
+
+        friend bool operator==(scratch_allocator const&, scratch_allocator const&) noexcept
+        {
+            return true;
+        }
+
+        friend bool operator!=(scratch_allocator const&, scratch_allocator const&) noexcept
+        {
+            return false;
+        }
+    };
+
+    using scratch_buffer = std::vector<limb_t, scratch_allocator<limb_t>>;
+}
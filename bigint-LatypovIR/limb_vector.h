@@ -0,0 +1,326 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Vector of unsigned integer limbs that keeps up to SMALL_SIZE limbs inline, without a heap allocation.
+// Limbs are trivially copyable, so they are moved around with memcpy; new limbs are zero unless given a value.
+// Heap buffers come from Allocator, which is propagated as std::allocator_traits says.
+template <typename Limb, size_t SMALL_SIZE, typename Allocator = std::allocator<Limb>>
+struct limb_vector : private Allocator
+{
+    static_assert(SMALL_SIZE > 0, "inline storage must hold at least one limb");
+
+    using value_type = Limb;
+    using allocator_type = Allocator;
+    using iterator = Limb*;
+    using const_iterator = Limb const*;
+
+    limb_vector() noexcept(noexcept(Allocator())) : Allocator(), size_(0), capacity_(SMALL_SIZE) {}
+
+    explicit limb_vector(Allocator const& allocator) noexcept : Allocator(allocator), size_(0), capacity_(SMALL_SIZE)
+    {
+    }
+
+    // n zero limbs
+    explicit limb_vector(size_t n, Allocator const& allocator = Allocator()) : limb_vector(allocator)
+    {
+        reserve(n);
+        resize(n);
+    }
+
+    limb_vector(limb_vector const& other)
+        : limb_vector(traits::select_on_container_copy_construction(other.get_allocator()))
+    {
+        reserve(other.size_);
+        copy_limbs(data(), other.data(), other.size_);
+        size_ = other.size_;
+    }
+
+    limb_vector(limb_vector&& other) noexcept : limb_vector(static_cast<Allocator&&>(other))
+    {
+        steal(other);
+    }
+
+    ~limb_vector()
+    {
+        release();
+    }
+
+    // keeps the current buffer if it is large enough
+    limb_vector& operator=(limb_vector const& other)
+    {
+        if (this != &other)
+        {
+            if (traits::propagate_on_container_copy_assignment::value && allocator() != other.allocator())
+            {
+                release();
+                allocator() = other.allocator();
+            }
+            assign_limbs(other);
+        }
+        return *this;
+    }
+
+    // takes the buffer of other unless the allocators differ and do not propagate, then copies the limbs
+    limb_vector& operator=(limb_vector&& other) noexcept(steals_on_move)
+    {
+        if (this != &other)
+        {
+            if (traits::propagate_on_container_move_assignment::value)
+            {
+                release();
+                allocator() = std::move(other.allocator());
+                steal(other);
+            }
+            else if (allocator() == other.allocator())
+            {
+                release();
+                steal(other);
+            }
+            else
+            {
+                assign_limbs(other);
+            }
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const noexcept
+    {
+        return allocator();
+    }
+
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    Limb* data() noexcept
+    {
+        return small() ? small_ : big_;
+    }
+
+    Limb const* data() const noexcept
+    {
+        return small() ? small_ : big_;
+    }
+
+    Limb& operator[](size_t i) noexcept
+    {
+        return data()[i];
+    }
+
+    Limb operator[](size_t i) const noexcept
+    {
+        return data()[i];
+    }
+
+    Limb& back() noexcept
+    {
+        return data()[size_ - 1];
+    }
+
+    Limb back() const noexcept
+    {
+        return data()[size_ - 1];
+    }
+
+    iterator begin() noexcept
+    {
+        return data();
+    }
+
+    iterator end() noexcept
+    {
+        return data() + size_;
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return data();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return data() + size_;
+    }
+
+    void reserve(size_t n)
+    {
+        if (n > capacity_)
+        {
+            reallocate(n);
+        }
+    }
+
+    void resize(size_t n, Limb value = 0)
+    {
+        if (n > size_)
+        {
+            if (n > capacity_)
+            {
+                reallocate(std::max(n, 2 * capacity_));
+            }
+            std::fill(data() + size_, data() + n, value);
+        }
+        size_ = n;
+    }
+
+    void assign(size_t n, Limb value)
+    {
+        size_ = 0;
+        resize(n, value);
+    }
+
+    void push_back(Limb value)
+    {
+        if (size_ == capacity_)
+        {
+            reallocate(2 * capacity_);
+        }
+        data()[size_++] = value;
+    }
+
+    void pop_back() noexcept
+    {
+        --size_;
+    }
+
+    void clear() noexcept
+    {
+        size_ = 0;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept
+    {
+        Limb* p = data();
+        size_t from = first - p;
+        size_t to = last - p;
+        std::memmove(p + from, p + to, (size_ - to) * sizeof(Limb));
+        size_ -= to - from;
+        return p + from;
+    }
+
+    void swap(limb_vector& other) noexcept(steals_on_move)
+    {
+        limb_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    friend bool operator==(limb_vector const& a, limb_vector const& b) noexcept
+    {
+        return a.size_ == b.size_ && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    friend bool operator!=(limb_vector const& a, limb_vector const& b) noexcept
+    {
+        return !(a == b);
+    }
+
+    friend void swap(limb_vector& a, limb_vector& b) noexcept(noexcept(a.swap(b)))
+    {
+        a.swap(b);
+    }
+
+private:
+    using traits = std::allocator_traits<Allocator>;
+    // an empty allocator type is always equal to itself, as std::allocator_traits::is_always_equal in C++17
+    static bool constexpr steals_on_move =
+        traits::propagate_on_container_move_assignment::value || std::is_empty<Allocator>::value;
+
+    size_t size_;
+    // SMALL_SIZE while the limbs are inline, heap buffers are always larger
+    size_t capacity_;
+    union
+    {
+        Limb small_[SMALL_SIZE];
+        Limb* big_;
+    };
+
+    bool small() const noexcept
+    {
+        return capacity_ == SMALL_SIZE;
+    }
+
+    static void copy_limbs(Limb* to, Limb const* from, size_t n) noexcept
+    {
+        if (n != 0)
+        {
+            std::memcpy(to, from, n * sizeof(Limb));
+        }
+    }
+
+    Allocator& allocator() noexcept
+    {
+        return *this;
+    }
+
+    Allocator const& allocator() const noexcept
+    {
+        return *this;
+    }
+
+    void assign_limbs(limb_vector const& other)
+    {
+        if (other.size_ > capacity_)
+        {
+            Limb* buffer = traits::allocate(allocator(), other.size_);
+            release();
+            big_ = buffer;
+            capacity_ = other.size_;
+        }
+        copy_limbs(data(), other.data(), other.size_);
+        size_ = other.size_;
+    }
+
+    void reallocate(size_t n)
+    {
+        Limb* buffer = traits::allocate(allocator(), n);
+        copy_limbs(buffer, data(), size_);
+        release();
+        big_ = buffer;
+        capacity_ = n;
+    }
+
+    void release() noexcept
+    {
+        if (!small())
+        {
+            traits::deallocate(allocator(), big_, capacity_);
+            capacity_ = SMALL_SIZE;
+        }
+    }
+
+    // takes the limbs of other, which is left empty; *this must be small
+    void steal(limb_vector& other) noexcept
+    {
+        if (other.small())
+        {
+            copy_limbs(small_, other.small_, other.size_);
+        }
+        else
+        {
+            big_ = other.big_;
+            capacity_ = other.capacity_;
+            other.capacity_ = SMALL_SIZE;
+        }
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+};
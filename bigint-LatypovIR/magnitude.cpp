@@ -0,0 +1,214 @@
+#include "magnitude.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define MAGNITUDE_ADD_CARRY_64
+#endif
+
+namespace
+{
+    // limbs in a 64-bit word
+    size_t constexpr WORD_LIMBS = 64 / magnitude::LIMB_BITS;
+}
+
+namespace magnitude
+{
+    int compare(limb_t const* a, size_t an, limb_t const* b, size_t bn)
+    {
+        while (an > 0 && a[an - 1] == 0)
+        {
+            --an;
+        }
+        while (bn > 0 && b[bn - 1] == 0)
+        {
+            --bn;
+        }
+        if (an != bn)
+        {
+            return an < bn ? -1 : 1;
+        }
+        for (size_t i = an; i != 0;)
+        {
+            --i;
+            if (a[i] != b[i])
+            {
+                return a[i] < b[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    limb_t add(limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn)
+    {
+        unsigned char carry = 0;
+        size_t i = 0;
+#ifdef MAGNITUDE_ADD_CARRY_64
+        // limbs as little-endian 64-bit words, two words per iteration through the carry flag
+        for (; i + 2 * WORD_LIMBS <= bn; i += 2 * WORD_LIMBS)
+        {
+            unsigned long long x0, x1, y0, y1, sum0, sum1;
+            std::memcpy(&x0, a + i, sizeof(x0));
+            std::memcpy(&x1, a + i + WORD_LIMBS, sizeof(x1));
+            std::memcpy(&y0, b + i, sizeof(y0));
+            std::memcpy(&y1, b + i + WORD_LIMBS, sizeof(y1));
+            carry = _addcarry_u64(carry, x0, y0, &sum0);
+            carry = _addcarry_u64(carry, x1, y1, &sum1);
+            std::memcpy(r + i, &sum0, sizeof(sum0));
+            std::memcpy(r + i + WORD_LIMBS, &sum1, sizeof(sum1));
+        }
+#endif
+        for (; i < bn; ++i)
+        {
+            double_limb_t sum = static_cast<double_limb_t>(a[i]) + b[i] + carry;
+            r[i] = static_cast<limb_t>(sum);
+            carry = static_cast<unsigned char>(sum >> LIMB_BITS);
+        }
+        for (; carry != 0 && i < an; ++i)
+        {
+            limb_t sum = a[i] + 1;
+            r[i] = sum;
+            carry = sum == 0 ? 1 : 0;
+        }
+        if (r != a)
+        {
+            std::copy(a + i, a + an, r + i);
+        }
+        return carry;
+    }
+
+    limb_t sub(limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn)
+    {
+        unsigned char borrow = 0;
+        size_t i = 0;
+#ifdef MAGNITUDE_ADD_CARRY_64
+        for (; i + 2 * WORD_LIMBS <= bn; i += 2 * WORD_LIMBS)
+        {
+            unsigned long long x0, x1, y0, y1, diff0, diff1;
+            std::memcpy(&x0, a + i, sizeof(x0));
+            std::memcpy(&x1, a + i + WORD_LIMBS, sizeof(x1));
+            std::memcpy(&y0, b + i, sizeof(y0));
+            std::memcpy(&y1, b + i + WORD_LIMBS, sizeof(y1));
+            borrow = _subborrow_u64(borrow, x0, y0, &diff0);
+            borrow = _subborrow_u64(borrow, x1, y1, &diff1);
+            std::memcpy(r + i, &diff0, sizeof(diff0));
+            std::memcpy(r + i + WORD_LIMBS, &diff1, sizeof(diff1));
+        }
+#endif
+        for (; i < bn; ++i)
+        {
+            double_limb_t diff = static_cast<double_limb_t>(a[i]) - b[i] - borrow;
+            r[i] = static_cast<limb_t>(diff);
+            borrow = (diff >> LIMB_BITS) != 0 ? 1 : 0;
+        }
+        for (; borrow != 0 && i < an; ++i)
+        {
+            limb_t x = a[i];
+            r[i] = x - 1;
+            borrow = x == 0 ? 1 : 0;
+        }
+        if (r != a)
+        {
+            std::copy(a + i, a + an, r + i);
+        }
+        return borrow;
+    }
+
+    limb_t lshift(limb_t* r, limb_t const* a, size_t n, unsigned shift)
+    {
+        if (n == 0 || shift == 0)
+        {
+            if (r != a)
+            {
+                std::copy_backward(a, a + n, r + n);
+            }
+            return 0;
+        }
+        limb_t out = a[n - 1] >> (LIMB_BITS - shift);
+        for (size_t i = n - 1; i != 0; --i)
+        {
+            r[i] = (a[i] << shift) | (a[i - 1] >> (LIMB_BITS - shift));
+        }
+        r[0] = a[0] << shift;
+        return out;
+    }
+
+    limb_t rshift(limb_t* r, limb_t const* a, size_t n, unsigned shift)
+    {
+        if (n == 0 || shift == 0)
+        {
+            if (r != a)
+            {
+                std::copy(a, a + n, r);
+            }
+            return 0;
+        }
+        limb_t out = a[0] << (LIMB_BITS - shift);
+        for (size_t i = 0; i + 1 < n; ++i)
+        {
+            r[i] = (a[i] >> shift) | (a[i + 1] << (LIMB_BITS - shift));
+        }
+        r[n - 1] = a[n - 1] >> shift;
+        return out;
+    }
+
+    limb_t neg(limb_t* r, limb_t const* a, size_t n)
+    {
+        // -a = ~a + 1: low zero limbs stay zero, the first non-zero one is negated, the rest inverted
+        size_t i = 0;
+        for (; i < n && a[i] == 0; ++i)
+        {
+            r[i] = 0;
+        }
+        if (i == n)
+        {
+            return 0;
+        }
+        r[i] = 0 - a[i];
+        for (++i; i < n; ++i)
+        {
+            r[i] = ~a[i];
+        }
+        return 1;
+    }
+
+    limb_t mul_1(limb_t* r, limb_t const* a, size_t n, limb_t b)
+    {
+        limb_t carry = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            double_limb_t product = static_cast<double_limb_t>(a[i]) * b + carry;
+            r[i] = static_cast<limb_t>(product);
+            carry = static_cast<limb_t>(product >> LIMB_BITS);
+        }
+        return carry;
+    }
+
+    limb_t addmul_1(limb_t* r, limb_t const* a, size_t n, limb_t b)
+    {
+        limb_t carry = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            double_limb_t product = static_cast<double_limb_t>(a[i]) * b + r[i] + carry;
+            r[i] = static_cast<limb_t>(product);
+            carry = static_cast<limb_t>(product >> LIMB_BITS);
+        }
+        return carry;
+    }
+
+    limb_t submul_1(limb_t* r, limb_t const* a, size_t n, limb_t b)
+    {
+        limb_t borrow = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            double_limb_t product = static_cast<double_limb_t>(a[i]) * b + borrow;
+            auto low = static_cast<limb_t>(product);
+            limb_t x = r[i];
+            r[i] = x - low;
+            borrow = static_cast<limb_t>(product >> LIMB_BITS) + (x < low ? 1 : 0);
+        }
+        return borrow;
+    }
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// limb width: 32 bits is portable, 64 bits needs unsigned __int128 (GCC and Clang on 64-bit targets)
+#ifndef BIGINT_LIMB_BITS
+#define BIGINT_LIMB_BITS 32
+#endif
+
+#if BIGINT_LIMB_BITS != 32 && BIGINT_LIMB_BITS != 64
+#error "BIGINT_LIMB_BITS must be 32 or 64"
+#endif
+
+// Kernels over unsigned little-endian limb arrays.
+// Sizes are in limbs; arrays may contain leading (high) zero limbs.
+namespace magnitude
+{
+#if BIGINT_LIMB_BITS == 64
+    using limb_t = uint64_t;
+    __extension__ typedef unsigned __int128 double_limb_t;
+#else
+    using limb_t = uint32_t;
+    using double_limb_t = uint64_t;
+#endif
+
+    constexpr unsigned LIMB_BITS = BIGINT_LIMB_BITS;
+    constexpr limb_t LIMB_MAX = ~limb_t(0);
+
+    struct mul_thresholds
+    {
+        // shorter operand below this size is multiplied by the schoolbook algorithm
+        size_t karatsuba = 32;
+        // balanced operands at least this long are multiplied by Toom-3
+        size_t toom3 = 640;
+        // shorter operand at least this long is multiplied by the number-theoretic transform
+        size_t ntt = 16384;
+    };
+
+    struct div_thresholds
+    {
+        // divisors at least this long are divided by Burnikel-Ziegler recursion instead of Knuth's algorithm D
+        size_t burnikel_ziegler = 24;
+        // numbers at least this long have their gcd reduced by half-gcd recursion instead of Lehmer's algorithm
+        size_t half_gcd = 128;
+    };
+
+    struct parallel_settings
+    {
+        // threads an operation may use, the calling one included; 1 keeps everything on the calling thread
+        size_t threads = 1;
+        // operands of at least that many limbs are multiplied and converted by several threads
+        size_t threshold = 16384;
+    };
+
+    // longest product mul_ntt can compute; the transform works on 32-bit coefficients
+    constexpr size_t NTT_MAX_SIZE = (size_t(1) << 26) / (LIMB_BITS / 32);
+
+    mul_thresholds& thresholds();
+    div_thresholds& division_thresholds();
+    // set before starting operations, not while they run
+    parallel_settings& parallel_execution();
+
+    // returns sign of a - b
+    int compare(limb_t const* a, size_t an, limb_t const* b, size_t bn);
+
+    // r[0..an) = a + b, an >= bn, returns carry; r may alias a or b
+    limb_t add(limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn);
+    // r[0..an) = a - b, an >= bn, returns borrow; r may alias a or b
+    limb_t sub(limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn);
+
+    // r[0..n) = a << shift, 0 <= shift < LIMB_BITS, returns the bits shifted out; r may alias a or overlap it from above
+    limb_t lshift(limb_t* r, limb_t const* a, size_t n, unsigned shift);
+    // r[0..n) = a >> shift, 0 <= shift < LIMB_BITS, returns the bits shifted out at the top of a limb;
+    // r may alias a or overlap it from below
+    limb_t rshift(limb_t* r, limb_t const* a, size_t n, unsigned shift);
+
+    // r[0..n) = 2^(n * LIMB_BITS) - a, the two's complement of a; returns 0 if a is zero, 1 otherwise; r may alias a
+    limb_t neg(limb_t* r, limb_t const* a, size_t n);
+
+    // r[i] = op(a[i], b[i]); r may alias a or b
+    template <typename Op>
+    void bitwise(limb_t* r, limb_t const* a, limb_t const* b, size_t n, Op op)
+    {
+        // independent iterations, vectorized by the compiler once op is inlined
+        for (size_t i = 0; i < n; ++i)
+        {
+            r[i] = op(a[i], b[i]);
+        }
+    }
+
+    // r[i] = op(a[i], b); r may alias a
+    template <typename Op>
+    void bitwise_1(limb_t* r, limb_t const* a, size_t n, limb_t b, Op op)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            r[i] = op(a[i], b);
+        }
+    }
+
+    // r[0..n) = a * b, returns high limb
+    limb_t mul_1(limb_t* r, limb_t const* a, size_t n, limb_t b);
+    // r[0..n) += a * b, returns high limb
+    limb_t addmul_1(limb_t* r, limb_t const* a, size_t n, limb_t b);
+
+    // r[0..n) -= a * b, returns the borrow limb
+    limb_t submul_1(limb_t* r, limb_t const* a, size_t n, limb_t b);
+
+    // r[0..an + bn) = a * b; r must not overlap a or b
+    void mul(limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn);
+    // r[0..2n) = a * a; r must not overlap a
+    void sqr(limb_t* r, limb_t const* a, size_t n);
+    // r[0..rn) += a * b and r[0..rn) -= a * b, rn >= an + bn, return the carry or borrow out of r;
+    // short operands are accumulated row by row without a temporary product; r must not overlap a or b
+    limb_t addmul(limb_t* r, size_t rn, limb_t const* a, size_t an, limb_t const* b, size_t bn);
+    limb_t submul(limb_t* r, size_t rn, limb_t const* a, size_t an, limb_t const* b, size_t bn);
+    // mul through a three-prime NTT, an + bn <= NTT_MAX_SIZE; passing a == b, an == bn squares with one transform
+    void mul_ntt(limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn);
+
+    // nonzero divisor prepared for division by multiplication with its reciprocal (Moller-Granlund)
+    struct limb_divisor
+    {
+        explicit limb_divisor(limb_t b);
+
+        // b << shift, with the top bit set
+        limb_t normalized;
+        // floor((2^(2 * LIMB_BITS) - 1) / normalized) - 2^LIMB_BITS
+        limb_t reciprocal;
+        unsigned shift;
+    };
+
+    // q[0..n) = a / b, returns a % b; q may alias a
+    limb_t divmod_1(limb_t* q, limb_t const* a, size_t n, limb_divisor const& b);
+    limb_t divmod_1(limb_t* q, limb_t const* a, size_t n, limb_t b);
+    // q[0..an - bn + 1) = a / b, r[0..bn) = a % b; an >= bn, b[bn - 1] != 0; q and r may alias a or b, but not each other
+    void divmod(limb_t* q, limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn);
+
+    // cofactors of the first Euclid steps on a >= b: (a; b) = (m00 m01; m10 m11) (a'; b') for the remainders
+    // a' > b' >= 0 the steps reach; the determinant is -1 after an odd number of steps and 1 otherwise
+    struct lehmer_matrix
+    {
+        limb_t m00;
+        limb_t m01;
+        limb_t m10;
+        limb_t m11;
+        bool odd;
+    };
+
+    // finds the steps from the leading limb of a >= b, both padded to n limbs, a[n - 1] != 0 (Knuth's algorithm L);
+    // false if it determines none
+    bool lehmer_cofactors(lehmer_matrix& m, limb_t const* a, limb_t const* b, size_t n);
+    // (a, b) = (a', b') for the steps found; t has 2n limbs of scratch
+    void lehmer_apply(limb_t* a, limb_t* b, size_t n, lehmer_matrix const& m, limb_t* t);
+    // g = gcd(a, b) by Lehmer's algorithm, returns its size; a[an - 1] != 0, g has room for an limbs,
+    // a and b are clobbered
+    size_t gcd(limb_t* g, limb_t* a, size_t an, limb_t* b, size_t bn);
+
+    // a^-1 mod 2^LIMB_BITS for odd a
+    limb_t inverse_limb(limb_t a);
+    // Montgomery reduction: r[0..n) = t * 2^(-n * LIMB_BITS) mod m for odd m and t[0..2n) < m * 2^(n * LIMB_BITS);
+    // inverse = -m^-1 mod 2^LIMB_BITS; t is clobbered, r may alias t + n
+    void redc(limb_t* r, limb_t* t, limb_t const* m, size_t n, limb_t inverse);
+}
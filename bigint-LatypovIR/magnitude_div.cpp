@@ -0,0 +1,215 @@
+#include "limb_memory.h"
+#include "magnitude.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+// Division of normalized operands (the divisor's top bit set): Knuth's algorithm D for short divisors,
+// Burnikel-Ziegler recursion for long ones, which divides in O(M(n) log n).
+// Every step divides a[0..dn + k) by d[0..dn) into k quotient limbs, returns the quotient limb
+// at position k (0 or 1) and leaves the remainder in a[0..dn).
+namespace magnitude
+{
+    div_thresholds& division_thresholds()
+    {
+        static div_thresholds instance;
+        return instance;
+    }
+
+    namespace
+    {
+        using buffer = scratch_buffer;
+
+        // the quotient of <u1, u0> by a normalized d with u1 < d, the remainder goes to r;
+        // two multiplications and no hardware division
+        limb_t divide_2by1(limb_t& r, limb_t u1, limb_t u0, limb_t d, limb_t reciprocal)
+        {
+            double_limb_t q = static_cast<double_limb_t>(reciprocal) * u1 + (static_cast<double_limb_t>(u1) << LIMB_BITS | u0);
+            auto q1 = static_cast<limb_t>(q >> LIMB_BITS) + 1;
+            auto q0 = static_cast<limb_t>(q);
+            limb_t remainder = u0 - q1 * d;
+            if (remainder > q0)
+            {
+                --q1;
+                remainder += d;
+            }
+            if (remainder >= d)
+            {
+                ++q1;
+                remainder -= d;
+            }
+            r = remainder;
+            return q1;
+        }
+
+        limb_t decrement(limb_t* a, size_t n)
+        {
+            limb_t one = 1;
+            return sub(a, a, n, &one, 1);
+        }
+
+        limb_t div_basecase(limb_t* q, limb_t* a, size_t k, limb_t const* d, size_t dn)
+        {
+            limb_t qh = compare(a + k, dn, d, dn) >= 0 ? 1 : 0;
+            if (qh != 0)
+            {
+                sub(a + k, a + k, dn, d, dn);
+            }
+
+            limb_t d1 = d[dn - 1];
+            limb_t d0 = dn >= 2 ? d[dn - 2] : 0;
+            limb_t reciprocal = limb_divisor(d1).reciprocal;
+            for (size_t j = k; j != 0;)
+            {
+                --j;
+                // a[j..j + dn] < d * 2^LIMB_BITS; the estimate from the top limbs is at most two too large
+                limb_t n2 = a[j + dn];
+                limb_t n1 = a[j + dn - 1];
+                limb_t n0 = dn >= 2 ? a[j + dn - 2] : 0;
+                limb_t qhat = ~limb_t(0);
+                if (n2 < d1)
+                {
+                    limb_t r;
+                    qhat = divide_2by1(r, n2, n1, d1, reciprocal);
+                    double_limb_t rhat = r;
+                    while (rhat >> LIMB_BITS == 0 && static_cast<double_limb_t>(qhat) * d0 > (rhat << LIMB_BITS | n0))
+                    {
+                        --qhat;
+                        rhat += d1;
+                    }
+                }
+
+                a[j + dn] = n2 - submul_1(a + j, d, dn, qhat);
+                // a negative partial remainder has all ones in its top limb until d is added back
+                while (a[j + dn] != 0)
+                {
+                    --qhat;
+                    a[j + dn] += add(a + j, a + j, dn, d, dn);
+                }
+                q[j] = qhat;
+            }
+            return qh;
+        }
+
+        limb_t div_block(limb_t* q, limb_t* a, size_t k, limb_t const* d, size_t dn);
+
+        // 2n by n limbs: two 3/2 steps, each dividing by the top half of d and correcting by the bottom half
+        limb_t div_recursive(limb_t* q, limb_t* a, limb_t const* d, size_t n)
+        {
+            if (n < std::max<size_t>(division_thresholds().burnikel_ziegler, 2))
+            {
+                return div_basecase(q, a, n, d, n);
+            }
+            size_t lo = n / 2;
+            size_t hi = n - lo;
+            limb_t qh = div_block(q + lo, a + lo, hi, d, n);
+            limb_t ql = div_block(q, a, lo, d, n);
+            assert(ql == 0);
+            (void)ql;
+            return qh;
+        }
+
+        limb_t div_block(limb_t* q, limb_t* a, size_t k, limb_t const* d, size_t dn)
+        {
+            assert(k <= dn);
+            if (k < std::max<size_t>(division_thresholds().burnikel_ziegler, 2))
+            {
+                return div_basecase(q, a, k, d, dn);
+            }
+            if (k == dn)
+            {
+                return div_recursive(q, a, d, dn);
+            }
+
+            // the top 2k limbs divided by the top k limbs of d overestimate the quotient by at most 2
+            size_t low = dn - k;
+            limb_t qh = div_recursive(q, a + low, d + low, k);
+            scratch_frame frame;
+            buffer t(dn);
+            mul(t.data(), q, k, d, low);
+            limb_t borrow = sub(a, a, dn, t.data(), dn);
+            if (qh != 0)
+            {
+                borrow += sub(a + k, a + k, low, d, low);
+            }
+            while (borrow != 0)
+            {
+                qh -= decrement(q, k);
+                borrow -= add(a, a, dn, d, dn);
+            }
+            return qh;
+        }
+    }
+
+    limb_divisor::limb_divisor(limb_t b) : shift(0)
+    {
+        while ((b << shift >> (LIMB_BITS - 1)) == 0)
+        {
+            ++shift;
+        }
+        normalized = b << shift;
+        // 2^(2 * LIMB_BITS) - 1 - 2^LIMB_BITS * normalized fits in a double limb
+        reciprocal = static_cast<limb_t>((static_cast<double_limb_t>(~normalized) << LIMB_BITS | LIMB_MAX) / normalized);
+    }
+
+    limb_t divmod_1(limb_t* q, limb_t const* a, size_t n, limb_divisor const& b)
+    {
+        if (n == 0)
+        {
+            return 0;
+        }
+        // divides a << shift by the normalized divisor, taking the shifted limbs on the fly
+        unsigned shift = b.shift;
+        limb_t remainder = shift == 0 ? 0 : a[n - 1] >> (LIMB_BITS - shift);
+        for (size_t i = n; i != 0;)
+        {
+            --i;
+            limb_t low = a[i] << shift;
+            if (shift != 0 && i != 0)
+            {
+                low |= a[i - 1] >> (LIMB_BITS - shift);
+            }
+            q[i] = divide_2by1(remainder, remainder, low, b.normalized, b.reciprocal);
+        }
+        return remainder >> shift;
+    }
+
+    limb_t divmod_1(limb_t* q, limb_t const* a, size_t n, limb_t b)
+    {
+        return divmod_1(q, a, n, limb_divisor(b));
+    }
+
+    void divmod(limb_t* q, limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn)
+    {
+        assert(an >= bn && bn > 0 && b[bn - 1] != 0);
+        if (bn == 1)
+        {
+            r[0] = divmod_1(q, a, an, b[0]);
+            return;
+        }
+
+        unsigned shift = 0;
+        while ((b[bn - 1] << shift >> (LIMB_BITS - 1)) == 0)
+        {
+            ++shift;
+        }
+        scratch_frame frame;
+        buffer d(bn);
+        lshift(d.data(), b, bn, shift);
+        buffer n(an + 1);
+        n[an] = lshift(n.data(), a, an, shift);
+
+        // quotient blocks of dn limbs from the top, the first one shorter
+        size_t qn = an - bn + 1;
+        size_t j = qn;
+        size_t k = qn % bn == 0 ? bn : qn % bn;
+        for (; j != 0; j -= k, k = bn)
+        {
+            limb_t qh = div_block(q + j - k, n.data() + j - k, k, d.data(), bn);
+            assert(qh == 0);
+            (void)qh;
+        }
+        rshift(r, n.data(), bn, shift);
+    }
+}
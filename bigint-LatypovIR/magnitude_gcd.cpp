@@ -0,0 +1,180 @@
+#include "limb_memory.h"
+#include "magnitude.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+// Lehmer's gcd: the quotients of several Euclid steps are found from the leading limb of the operands
+// (Knuth's algorithm L), then applied to the full numbers at once with single-limb cofactors.
+namespace magnitude
+{
+    namespace
+    {
+#if BIGINT_LIMB_BITS == 64
+        __extension__ typedef __int128 signed_double_limb_t;
+#else
+        using signed_double_limb_t = int64_t;
+#endif
+
+        limb_t gcd_limbs(limb_t a, limb_t b)
+        {
+            if (a == 0 || b == 0)
+            {
+                return a | b;
+            }
+            // binary gcd
+            unsigned shift = 0;
+            for (; ((a | b) & 1) == 0; ++shift)
+            {
+                a >>= 1;
+                b >>= 1;
+            }
+            while ((a & 1) == 0)
+            {
+                a >>= 1;
+            }
+            while (b != 0)
+            {
+                while ((b & 1) == 0)
+                {
+                    b >>= 1;
+                }
+                if (a > b)
+                {
+                    std::swap(a, b);
+                }
+                b -= a;
+            }
+            return a << shift;
+        }
+
+        // the limb of x[0..n) starting at the leading bit of a limb with `zeros` leading zeros
+        limb_t leading_limb(limb_t const* x, size_t n, unsigned zeros)
+        {
+            limb_t high = x[n - 1];
+            limb_t low = n >= 2 ? x[n - 2] : 0;
+            return zeros == 0 ? high : high << zeros | low >> (LIMB_BITS - zeros);
+        }
+
+        limb_t magnitude_of(signed_double_limb_t x)
+        {
+            return static_cast<limb_t>(x < 0 ? -x : x);
+        }
+
+        size_t trimmed(limb_t const* x, size_t n)
+        {
+            while (n > 0 && x[n - 1] == 0)
+            {
+                --n;
+            }
+            return n;
+        }
+    }
+
+    bool lehmer_cofactors(lehmer_matrix& m, limb_t const* a, limb_t const* b, size_t n)
+    {
+        unsigned zeros = 0;
+        while ((a[n - 1] << zeros >> (LIMB_BITS - 1)) == 0)
+        {
+            ++zeros;
+        }
+        signed_double_limb_t x = leading_limb(a, n, zeros);
+        signed_double_limb_t y = leading_limb(b, n, zeros);
+        // (x; y) = (A B; C D) (leading limbs of a and b); a quotient is taken only when both bounds of the
+        // full operands agree on it, the cofactors stay below 2^LIMB_BITS
+        signed_double_limb_t A = 1, B = 0, C = 0, D = 1;
+        bool odd = false;
+        while (y + C != 0 && y + D != 0)
+        {
+            signed_double_limb_t q = (x + A) / (y + C);
+            if (q != (x + B) / (y + D))
+            {
+                break;
+            }
+            signed_double_limb_t t = A - q * C;
+            A = C;
+            C = t;
+            t = B - q * D;
+            B = D;
+            D = t;
+            t = x - q * y;
+            x = y;
+            y = t;
+            odd = !odd;
+        }
+        if (B == 0)
+        {
+            return false;
+        }
+        // the inverse of (A B; C D), whose entries alternate in sign
+        m.m00 = magnitude_of(D);
+        m.m01 = magnitude_of(B);
+        m.m10 = magnitude_of(C);
+        m.m11 = magnitude_of(A);
+        m.odd = odd;
+        return true;
+    }
+
+    void lehmer_apply(limb_t* a, limb_t* b, size_t n, lehmer_matrix const& m, limb_t* t)
+    {
+        // a' = +-(m11 a - m01 b), b' = +-(m00 b - m10 a), the sign making both nonnegative
+        limb_t* x = t;
+        limb_t* y = t + n;
+        limb_t overflow_x;
+        limb_t overflow_y;
+        if (!m.odd)
+        {
+            overflow_x = mul_1(x, a, n, m.m11) - submul_1(x, b, n, m.m01);
+            overflow_y = mul_1(y, b, n, m.m00) - submul_1(y, a, n, m.m10);
+        }
+        else
+        {
+            overflow_x = mul_1(x, b, n, m.m01) - submul_1(x, a, n, m.m11);
+            overflow_y = mul_1(y, a, n, m.m10) - submul_1(y, b, n, m.m00);
+        }
+        assert(overflow_x == 0 && overflow_y == 0);
+        (void)overflow_x;
+        (void)overflow_y;
+        std::copy(x, x + n, a);
+        std::copy(y, y + n, b);
+    }
+
+    size_t gcd(limb_t* g, limb_t* a, size_t an, limb_t* b, size_t bn)
+    {
+        bn = trimmed(b, bn);
+        if (compare(a, an, b, bn) < 0)
+        {
+            std::swap(a, b);
+            std::swap(an, bn);
+        }
+        scratch_frame frame;
+        scratch_buffer scratch(2 * an);
+        while (bn > 1)
+        {
+            lehmer_matrix m;
+            if (an == bn && lehmer_cofactors(m, a, b, an))
+            {
+                lehmer_apply(a, b, an, m, scratch.data());
+                an = trimmed(a, an);
+            }
+            else
+            {
+                // a Euclid step: the remainder is written over a, which then takes the place of b
+                divmod(scratch.data(), a, a, an, b, bn);
+                an = bn;
+                std::swap(a, b);
+                std::swap(an, bn);
+            }
+            bn = trimmed(b, bn);
+        }
+        if (bn == 0)
+        {
+            std::copy(a, a + an, g);
+            return an;
+        }
+        g[0] = gcd_limbs(b[0], divmod_1(a, a, an, b[0]));
+        return 1;
+    }
+}
@@ -0,0 +1,34 @@
+#include "magnitude.h"
+
+// Montgomery reduction: t * R^-1 mod m for R = 2^(n * LIMB_BITS) is computed by n multiply-accumulate passes
+// that zero the low limbs of t one by one, so a modular product costs a multiplication and no division.
+namespace magnitude
+{
+    limb_t inverse_limb(limb_t a)
+    {
+        // Newton's iteration x = x * (2 - a * x) doubles the number of correct low bits; a is its own inverse mod 8
+        limb_t x = a;
+        for (unsigned bits = 3; bits < LIMB_BITS; bits *= 2)
+        {
+            x *= 2 - a * x;
+        }
+        return x;
+    }
+
+    void redc(limb_t* r, limb_t* t, limb_t const* m, size_t n, limb_t inverse)
+    {
+        // step i adds u * m * 2^(i * LIMB_BITS), which zeroes t[i]; its carry belongs at t[i + n] and is
+        // parked in the freed t[i] until the end
+        for (size_t i = 0; i < n; ++i)
+        {
+            limb_t u = t[i] * inverse;
+            t[i] = addmul_1(t + i, m, n, u);
+        }
+        // the sum is below 2m
+        limb_t carry = add(r, t + n, n, t, n);
+        if (carry != 0 || compare(r, n, m, n) >= 0)
+        {
+            sub(r, r, n, m, n);
+        }
+    }
+}
@@ -0,0 +1,448 @@
+#include "limb_memory.h"
+#include "magnitude.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace magnitude
+{
+    mul_thresholds& thresholds()
+    {
+        static mul_thresholds instance;
+        return instance;
+    }
+
+    namespace
+    {
+        // temporaries live in the scratch arena of the thread, each function that makes them opens a frame
+        using buffer = scratch_buffer;
+
+        size_t trimmed_size(limb_t const* a, size_t n)
+        {
+            while (n > 0 && a[n - 1] == 0)
+            {
+                --n;
+            }
+            return n;
+        }
+
+        void trim(buffer& a)
+        {
+            a.resize(trimmed_size(a.data(), a.size()));
+        }
+
+        void mul_dispatch(limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn);
+
+        // an >= bn >= 1
+        void mul_basecase(limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn)
+        {
+            r[an] = mul_1(r, a, an, b[0]);
+            for (size_t j = 1; j < bn; ++j)
+            {
+                r[an + j] = addmul_1(r + j, a, an, b[j]);
+            }
+        }
+
+        // r[0..2n) = a * a; off-diagonal products are computed once and doubled
+        void sqr_basecase(limb_t* r, limb_t const* a, size_t n)
+        {
+            std::fill(r, r + 2 * n, 0);
+            for (size_t i = 0; i + 1 < n; ++i)
+            {
+                r[i + n] = addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+            }
+
+            limb_t high = 0;
+            for (size_t i = 0; i < 2 * n; ++i)
+            {
+                limb_t next = r[i] >> (LIMB_BITS - 1);
+                r[i] = (r[i] << 1) | high;
+                high = next;
+            }
+
+            limb_t carry = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                double_limb_t diagonal = static_cast<double_limb_t>(a[i]) * a[i];
+                double_limb_t low = static_cast<double_limb_t>(r[2 * i]) + static_cast<limb_t>(diagonal) + carry;
+                r[2 * i] = static_cast<limb_t>(low);
+                double_limb_t top = static_cast<double_limb_t>(r[2 * i + 1]) + (diagonal >> LIMB_BITS) +
+                                    (low >> LIMB_BITS);
+                r[2 * i + 1] = static_cast<limb_t>(top);
+                carry = static_cast<limb_t>(top >> LIMB_BITS);
+            }
+        }
+
+        // an >= 2 * bn: a is cut into bn-sized chunks, each multiplied by b
+        void mul_unbalanced(limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn)
+        {
+            mul_dispatch(r, a, bn, b, bn);
+            scratch_frame frame;
+            buffer tmp(2 * bn);
+            for (size_t offset = bn; offset < an; offset += bn)
+            {
+                size_t len = std::min(bn, an - offset);
+                mul_dispatch(tmp.data(), a + offset, len, b, bn);
+                std::copy(tmp.begin() + bn, tmp.begin() + bn + len, r + offset + bn);
+                limb_t carry = add(r + offset, r + offset, bn + len, tmp.data(), bn);
+                assert(carry == 0);
+                (void)carry;
+            }
+        }
+
+        // an >= bn > an / 2
+        void mul_karatsuba(limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn)
+        {
+            bool square = a == b && an == bn;
+            size_t m = an / 2;
+            size_t a1n = an - m;
+            size_t b1n = bn - m;
+
+            scratch_frame frame;
+            buffer sa(a1n + 1);
+            sa[a1n] = add(sa.data(), a + m, a1n, a, m);
+            buffer sb;
+            if (!square)
+            {
+                sb.resize(std::max(m, b1n) + 1);
+                if (m >= b1n)
+                {
+                    sb[m] = add(sb.data(), b, m, b + m, b1n);
+                }
+                else
+                {
+                    sb[b1n] = add(sb.data(), b + m, b1n, b, m);
+                }
+            }
+            buffer const& sbr = square ? sa : sb;
+
+            // the three half-size products are independent
+            buffer t(sa.size() + sbr.size());
+            fork_join(
+                bn, [&] { mul_dispatch(t.data(), sa.data(), sa.size(), sbr.data(), sbr.size()); },
+                [&] {
+                    fork_join(
+                        bn, [&] { mul_dispatch(r + 2 * m, a + m, a1n, b + m, b1n); },
+                        [&] { mul_dispatch(r, a, m, b, m); });
+                });
+            sub(t.data(), t.data(), t.size(), r, 2 * m);
+            sub(t.data(), t.data(), t.size(), r + 2 * m, an + bn - 2 * m);
+            trim(t);
+
+            limb_t carry = add(r + m, r + m, an + bn - m, t.data(), t.size());
+            assert(carry == 0);
+            (void)carry;
+        }
+
+        // Signed values appearing during Toom-3 evaluation and interpolation.
+        struct signed_buffer
+        {
+            buffer mag;
+            bool negative = false;
+        };
+
+        buffer slice(limb_t const* a, size_t from, size_t to)
+        {
+            buffer result(a + from, a + to);
+            trim(result);
+            return result;
+        }
+
+        buffer sum(buffer const& x, buffer const& y)
+        {
+            buffer const& big = x.size() >= y.size() ? x : y;
+            buffer const& small = x.size() >= y.size() ? y : x;
+            buffer result(big.size() + 1);
+            result[big.size()] = add(result.data(), big.data(), big.size(), small.data(), small.size());
+            trim(result);
+            return result;
+        }
+
+        // x >= y
+        buffer difference(buffer const& x, buffer const& y)
+        {
+            buffer result(x.size());
+            sub(result.data(), x.data(), x.size(), y.data(), y.size());
+            trim(result);
+            return result;
+        }
+
+
+        signed_buffer sum(signed_buffer const& x, signed_buffer const& y)
+        {
+            if (x.negative == y.negative)
+            {
+                return {sum(x.mag, y.mag), x.negative};
+            }
+            int cmp = compare(x.mag.data(), x.mag.size(), y.mag.data(), y.mag.size());
+            if (cmp == 0)
+            {
+                return {};
+            }
+            return cmp > 0 ? signed_buffer{difference(x.mag, y.mag), x.negative}
+                           : signed_buffer{difference(y.mag, x.mag), y.negative};
+        }
+
+        signed_buffer difference(signed_buffer const& x, signed_buffer y)
+        {
+            y.negative = !y.negative && !y.mag.empty();
+            return sum(x, y);
+        }
+
+        // result = x * y in two halves: the buffer is sized on the calling thread, so that the product itself
+        // can be computed by a forked task writing into the scratch memory of this thread
+        void prepare_product(signed_buffer& result, signed_buffer const& x, signed_buffer const& y)
+        {
+            result.mag.assign(x.mag.empty() || y.mag.empty() ? 0 : x.mag.size() + y.mag.size(), 0);
+            result.negative = x.negative != y.negative && !result.mag.empty();
+        }
+
+        void compute_product(signed_buffer& result, signed_buffer const& x, signed_buffer const& y)
+        {
+            if (!result.mag.empty())
+            {
+                mul_dispatch(result.mag.data(), x.mag.data(), x.mag.size(), y.mag.data(), y.mag.size());
+            }
+        }
+
+        void shift_left_1(signed_buffer& x)
+        {
+            x.mag.push_back(0);
+            for (size_t i = x.mag.size() - 1; i > 0; --i)
+            {
+                x.mag[i] = (x.mag[i] << 1) | (x.mag[i - 1] >> (LIMB_BITS - 1));
+            }
+            x.mag[0] <<= 1;
+            trim(x.mag);
+        }
+
+        // x is known to be even
+        void shift_right_1(signed_buffer& x)
+        {
+            for (size_t i = 0; i < x.mag.size(); ++i)
+            {
+                limb_t high = i + 1 < x.mag.size() ? x.mag[i + 1] << (LIMB_BITS - 1) : 0;
+                x.mag[i] = (x.mag[i] >> 1) | high;
+            }
+            trim(x.mag);
+        }
+
+        // x is known to be a multiple of 3: exact division from the low end, multiplying by 3^-1 mod 2^LIMB_BITS
+        void divide_exact_3(signed_buffer& x)
+        {
+            limb_t constexpr INVERSE_3 = LIMB_MAX / 3 * 2 + 1;
+            limb_t borrow = 0;
+            for (limb_t& limb : x.mag)
+            {
+                limb_t s = limb - borrow;
+                limb_t q = s * INVERSE_3;
+                // q * 3 = s + borrow' * 2^LIMB_BITS, where s wrapped around if the subtraction borrowed
+                borrow = static_cast<limb_t>(static_cast<double_limb_t>(q) * 3 >> LIMB_BITS) + (limb < borrow ? 1 : 0);
+                limb = q;
+            }
+            assert(borrow == 0);
+            trim(x.mag);
+        }
+
+        void add_at(limb_t* r, size_t rn, size_t offset, signed_buffer const& x)
+        {
+            assert(!x.negative);
+            if (x.mag.empty())
+            {
+                return;
+            }
+            limb_t carry = add(r + offset, r + offset, rn - offset, x.mag.data(), x.mag.size());
+            assert(carry == 0);
+            (void)carry;
+        }
+
+        // values of p(x) = p0 + p1 x + p2 x^2 at 1, -1 and -2
+        void toom3_evaluate(limb_t const* a, size_t an, size_t k, signed_buffer& p1, signed_buffer& pm1,
+                            signed_buffer& pm2)
+        {
+            signed_buffer a0{slice(a, 0, k)};
+            signed_buffer a1{slice(a, k, std::min(an, 2 * k))};
+            signed_buffer a2{an > 2 * k ? slice(a, 2 * k, an) : buffer()};
+
+            signed_buffer t = sum(a0, a2);
+            p1 = sum(t, a1);
+            pm1 = difference(t, a1);
+            pm2 = sum(pm1, a2);
+            shift_left_1(pm2);
+            pm2 = difference(pm2, a0);
+        }
+
+        // an >= bn > 2 * ceil(an / 3); evaluation at 0, 1, -1, -2, inf with Bodrato's interpolation sequence
+        void mul_toom3(limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn)
+        {
+            size_t k = (an + 2) / 3;
+            size_t rn = an + bn;
+
+            bool square = a == b && an == bn;
+
+            scratch_frame frame;
+            signed_buffer p1, pm1, pm2, q1, qm1, qm2;
+            toom3_evaluate(a, an, k, p1, pm1, pm2);
+            if (!square)
+            {
+                toom3_evaluate(b, bn, k, q1, qm1, qm2);
+            }
+
+            // the five products at the evaluation points are independent
+            signed_buffer r1, rm1, r3;
+            prepare_product(r1, p1, square ? p1 : q1);
+            prepare_product(rm1, pm1, square ? pm1 : qm1);
+            prepare_product(r3, pm2, square ? pm2 : qm2);
+            fork_join(
+                bn,
+                [&] {
+                    mul_dispatch(r, a, k, b, k);
+                    mul_dispatch(r + 4 * k, a + 2 * k, an - 2 * k, b + 2 * k, bn - 2 * k);
+                },
+                [&] {
+                    fork_join(
+                        bn, [&] { compute_product(r1, p1, square ? p1 : q1); },
+                        [&] {
+                            fork_join(
+                                bn, [&] { compute_product(rm1, pm1, square ? pm1 : qm1); },
+                                [&] { compute_product(r3, pm2, square ? pm2 : qm2); });
+                        });
+                });
+            trim(r1.mag);
+            trim(rm1.mag);
+            trim(r3.mag);
+            std::fill(r + 2 * k, r + 4 * k, 0);
+
+            signed_buffer r0{slice(r, 0, 2 * k)};
+            signed_buffer rinf{slice(r, 4 * k, rn)};
+
+            r3 = difference(r3, r1);
+            divide_exact_3(r3);
+            r1 = difference(r1, rm1);
+            shift_right_1(r1);
+            signed_buffer r2 = difference(rm1, r0);
+            r3 = difference(r2, r3);
+            shift_right_1(r3);
+            signed_buffer twice_rinf = rinf;
+            shift_left_1(twice_rinf);
+            r3 = sum(r3, twice_rinf);
+            r2 = difference(sum(r2, r1), rinf);
+            r1 = difference(r1, r3);
+
+            add_at(r, rn, k, r1);
+            add_at(r, rn, 2 * k, r2);
+            add_at(r, rn, 3 * k, r3);
+        }
+
+        void mul_dispatch(limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn)
+        {
+            if (an < bn)
+            {
+                std::swap(a, b);
+                std::swap(an, bn);
+            }
+            size_t rn = an + bn;
+            an = trimmed_size(a, an);
+            bn = trimmed_size(b, bn);
+            if (an < bn)
+            {
+                std::swap(a, b);
+                std::swap(an, bn);
+            }
+            std::fill(r + an + bn, r + rn, 0);
+
+            mul_thresholds const& t = thresholds();
+            if (bn == 0)
+            {
+                std::fill(r, r + an, 0);
+            }
+            else if (bn < std::max<size_t>(t.karatsuba, 2))
+            {
+                if (a == b && an == bn)
+                {
+                    sqr_basecase(r, a, an);
+                }
+                else
+                {
+                    mul_basecase(r, a, an, b, bn);
+                }
+            }
+            else if (bn >= t.ntt && an + bn <= NTT_MAX_SIZE)
+            {
+                mul_ntt(r, a, an, b, bn);
+            }
+            else if (an >= 2 * bn)
+            {
+                mul_unbalanced(r, a, an, b, bn);
+            }
+            else if (bn < t.toom3 || bn <= 2 * ((an + 2) / 3))
+            {
+                mul_karatsuba(r, a, an, b, bn);
+            }
+            else
+            {
+                mul_toom3(r, a, an, b, bn);
+            }
+        }
+    }
+
+    void mul(limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn)
+    {
+        mul_dispatch(r, a, an, b, bn);
+    }
+
+    void sqr(limb_t* r, limb_t const* a, size_t n)
+    {
+        mul_dispatch(r, a, n, a, n);
+    }
+
+    limb_t addmul(limb_t* r, size_t rn, limb_t const* a, size_t an, limb_t const* b, size_t bn)
+    {
+        if (an < bn)
+        {
+            std::swap(a, b);
+            std::swap(an, bn);
+        }
+        limb_t carry = 0;
+        if (bn < thresholds().karatsuba)
+        {
+            // rows of the schoolbook product go straight into r
+            for (size_t j = 0; j < bn; ++j)
+            {
+                limb_t high = addmul_1(r + j, a, an, b[j]);
+                carry += add(r + j + an, r + j + an, rn - j - an, &high, 1);
+            }
+            return carry;
+        }
+        scratch_frame frame;
+        buffer product(an + bn);
+        mul_dispatch(product.data(), a, an, b, bn);
+        return add(r, r, rn, product.data(), an + bn);
+    }
+
+    limb_t submul(limb_t* r, size_t rn, limb_t const* a, size_t an, limb_t const* b, size_t bn)
+    {
+        if (an < bn)
+        {
+            std::swap(a, b);
+            std::swap(an, bn);
+        }
+        limb_t borrow = 0;
+        if (bn < thresholds().karatsuba)
+        {
+            for (size_t j = 0; j < bn; ++j)
+            {
+                limb_t high = submul_1(r + j, a, an, b[j]);
+                borrow += sub(r + j + an, r + j + an, rn - j - an, &high, 1);
+            }
+            return borrow;
+        }
+        scratch_frame frame;
+        buffer product(an + bn);
+        mul_dispatch(product.data(), a, an, b, bn);
+        return sub(r, r, rn, product.data(), an + bn);
+    }
+}
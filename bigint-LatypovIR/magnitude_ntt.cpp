@@ -0,0 +1,298 @@
+#include "magnitude.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+// Multiplication by number-theoretic transforms modulo three primes below 2^31.
+// 32-bit words are used as coefficients directly (64-bit limbs are split in halves): a coefficient
+// of the product is less than min(an, bn) * 2^64 <= 2^89, which the product of the primes
+// (about 2^90.5) covers, and the result is restored by the Chinese remainder theorem (Garner's algorithm).
+namespace magnitude
+{
+    namespace
+    {
+        constexpr uint32_t negated_inverse(uint32_t p)
+        {
+            uint32_t inverse = p;
+            for (int i = 0; i < 5; ++i)
+            {
+                inverse *= 2 - p * inverse;
+            }
+            return 0 - inverse;
+        }
+
+        constexpr uint32_t montgomery_r_squared(uint32_t p)
+        {
+            uint64_t r = (uint64_t(1) << 32) % p;
+            return static_cast<uint32_t>(r * r % p);
+        }
+
+        // calls butterfly(i, j) for the n / 2 butterflies of a level with blocks of 2len starting at i, 0 <= j < len;
+        // the butterflies are independent and shared between threads on long transforms
+        template <typename Butterfly>
+        void for_each_butterfly(size_t n, size_t len, Butterfly const& butterfly)
+        {
+            parallel_for(n / 2, [&](size_t begin, size_t end) {
+                for (size_t p = begin; p < end;)
+                {
+                    size_t j = p & (len - 1);
+                    size_t i = (p - j) * 2;
+                    size_t last = std::min(len, j + (end - p));
+                    p += last - j;
+                    for (; j < last; ++j)
+                    {
+                        butterfly(i, j);
+                    }
+                }
+            });
+        }
+
+        // Montgomery arithmetic modulo P = c * 2^k + 1 with primitive root G, R = 2^32.
+        // Twiddles are kept in Montgomery form, so multiplying a plain residue by one gives a plain residue.
+        template <uint32_t P, uint32_t G>
+        struct ntt_prime
+        {
+            static constexpr uint32_t NEG_INV = negated_inverse(P);
+            static constexpr uint32_t R2 = montgomery_r_squared(P);
+
+            static uint32_t reduce(uint64_t t)
+            {
+                uint32_t m = static_cast<uint32_t>(t) * NEG_INV;
+                auto result = static_cast<uint32_t>((t + static_cast<uint64_t>(m) * P) >> 32);
+                return result >= P ? result - P : result;
+            }
+
+            static uint32_t mul(uint32_t a, uint32_t b)
+            {
+                return reduce(static_cast<uint64_t>(a) * b);
+            }
+
+            static uint32_t add(uint32_t a, uint32_t b)
+            {
+                uint32_t sum = a + b;
+                return sum >= P ? sum - P : sum;
+            }
+
+            static uint32_t sub(uint32_t a, uint32_t b)
+            {
+                return a >= b ? a - b : a + P - b;
+            }
+
+            static uint32_t to_montgomery(uint32_t x)
+            {
+                return mul(x % P, R2);
+            }
+
+            static uint32_t pow(uint32_t base, uint64_t e)
+            {
+                uint32_t result = to_montgomery(1);
+                for (; e != 0; e >>= 1)
+                {
+                    if ((e & 1) != 0)
+                    {
+                        result = mul(result, base);
+                    }
+                    base = mul(base, base);
+                }
+                return result;
+            }
+
+            // Montgomery form of x^-1 mod P
+            static uint32_t inverse(uint32_t x)
+            {
+                return pow(to_montgomery(x), P - 2);
+            }
+
+            // roots[len + j] = w^j for the primitive 2len-th root w, len = 1, 2, 4, ..., n / 2
+            static void compute_roots(std::vector<uint32_t>& roots, size_t n, bool inverse)
+            {
+                roots.resize(n);
+                for (size_t len = 1; len < n; len <<= 1)
+                {
+                    uint32_t w = pow(to_montgomery(G), (P - 1) / (2 * len));
+                    if (inverse)
+                    {
+                        w = pow(w, 2 * len - 1);
+                    }
+                    uint32_t x = to_montgomery(1);
+                    for (size_t j = 0; j < len; ++j)
+                    {
+                        roots[len + j] = x;
+                        x = mul(x, w);
+                    }
+                }
+            }
+
+            // decimation in frequency: natural order in, bit-reversed order out
+            static void forward(std::vector<uint32_t>& f, std::vector<uint32_t> const& roots)
+            {
+                size_t n = f.size();
+                uint32_t* x = f.data();
+                uint32_t const* w = roots.data();
+                for (size_t len = n / 2; len >= 1; len >>= 1)
+                {
+                    for_each_butterfly(n, len, [x, w, len](size_t i, size_t j) {
+                        uint32_t u = x[i + j];
+                        uint32_t v = x[i + j + len];
+                        x[i + j] = add(u, v);
+                        x[i + j + len] = mul(sub(u, v), w[len + j]);
+                    });
+                }
+            }
+
+            // decimation in time: bit-reversed order in, natural order out, scaled by n
+            static void backward(std::vector<uint32_t>& f, std::vector<uint32_t> const& roots)
+            {
+                size_t n = f.size();
+                uint32_t* x = f.data();
+                uint32_t const* w = roots.data();
+                for (size_t len = 1; len < n; len <<= 1)
+                {
+                    for_each_butterfly(n, len, [x, w, len](size_t i, size_t j) {
+                        uint32_t u = x[i + j];
+                        uint32_t v = mul(x[i + j + len], w[len + j]);
+                        x[i + j] = add(u, v);
+                        x[i + j + len] = sub(u, v);
+                    });
+                }
+            }
+
+            static void load(std::vector<uint32_t>& f, uint32_t const* a, size_t an, size_t n)
+            {
+                f.assign(n, 0);
+                for (size_t i = 0; i < an; ++i)
+                {
+                    f[i] = a[i] % P;
+                }
+            }
+
+            // f = (a * b) mod P, coefficient-wise
+            static void convolve(std::vector<uint32_t>& f, uint32_t const* a, size_t an, uint32_t const* b, size_t bn,
+                                 size_t n)
+            {
+                std::vector<uint32_t> roots;
+                compute_roots(roots, n, false);
+                std::vector<uint32_t> g;
+                bool square = a == b && an == bn;
+                fork_join(
+                    n,
+                    [&] {
+                        if (!square)
+                        {
+                            load(g, b, bn, n);
+                            forward(g, roots);
+                        }
+                    },
+                    [&] {
+                        load(f, a, an, n);
+                        forward(f, roots);
+                    });
+                uint32_t const* y = square ? f.data() : g.data();
+                parallel_for(n, [&f, y](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        f[i] = mul(f[i], y[i]);
+                    }
+                });
+
+                compute_roots(roots, n, true);
+                backward(f, roots);
+                // pointwise products carry an extra R^-1, the backward transform an extra n
+                uint32_t scale = to_montgomery(inverse(static_cast<uint32_t>(n % P)));
+                parallel_for(n, [&f, scale](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        f[i] = mul(f[i], scale);
+                    }
+                });
+            }
+        };
+
+        uint32_t constexpr P1 = 2013265921; // 15 * 2^27 + 1
+        uint32_t constexpr P2 = 1811939329; // 27 * 2^26 + 1
+        uint32_t constexpr P3 = 469762049;  // 7 * 2^26 + 1
+
+        using prime_1 = ntt_prime<P1, 31>;
+        using prime_2 = ntt_prime<P2, 13>;
+        using prime_3 = ntt_prime<P3, 3>;
+
+        void ntt_multiply(uint32_t* r, uint32_t const* a, size_t an, uint32_t const* b, size_t bn)
+        {
+            size_t rn = an + bn;
+            size_t n = 1;
+            while (n < rn)
+            {
+                n <<= 1;
+            }
+
+            // the three transforms are independent
+            std::vector<uint32_t> r1, r2, r3;
+            fork_join(
+                n, [&] { prime_1::convolve(r1, a, an, b, bn, n); },
+                [&] {
+                    fork_join(
+                        n, [&] { prime_2::convolve(r2, a, an, b, bn, n); },
+                        [&] { prime_3::convolve(r3, a, an, b, bn, n); });
+                });
+
+            uint32_t p1_inverse_2 = prime_2::inverse(P1);
+            uint32_t p1_inverse_3 = prime_3::inverse(P1);
+            uint32_t p2_inverse_3 = prime_3::inverse(P2);
+
+            // x = x1 + P1 * (t2 + P2 * t3) is accumulated into r through a three-word carry
+            uint32_t carry[3] = {0, 0, 0};
+            for (size_t k = 0; k < rn; ++k)
+            {
+                uint32_t x1 = r1[k];
+                uint32_t t2 = prime_2::mul(prime_2::sub(r2[k], x1 % P2), p1_inverse_2);
+                uint32_t t3 = prime_3::mul(prime_3::sub(r3[k], x1 % P3), p1_inverse_3);
+                t3 = prime_3::mul(prime_3::sub(t3, t2 % P3), p2_inverse_3);
+
+                uint64_t u = t2 + static_cast<uint64_t>(P2) * t3;
+                uint64_t low = static_cast<uint64_t>(P1) * static_cast<uint32_t>(u) + x1;
+                uint64_t high = static_cast<uint64_t>(P1) * (u >> 32) + (low >> 32);
+
+                uint64_t s0 = static_cast<uint64_t>(static_cast<uint32_t>(low)) + carry[0];
+                uint64_t s1 = static_cast<uint64_t>(static_cast<uint32_t>(high)) + carry[1] + (s0 >> 32);
+                uint64_t s2 = (high >> 32) + carry[2] + (s1 >> 32);
+                r[k] = static_cast<uint32_t>(s0);
+                carry[0] = static_cast<uint32_t>(s1);
+                carry[1] = static_cast<uint32_t>(s2);
+                carry[2] = static_cast<uint32_t>(s2 >> 32);
+            }
+            assert(carry[0] == 0 && carry[1] == 0 && carry[2] == 0);
+        }
+
+#if BIGINT_LIMB_BITS == 64
+        std::vector<uint32_t> halves(limb_t const* a, size_t n)
+        {
+            std::vector<uint32_t> result(2 * n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                result[2 * i] = static_cast<uint32_t>(a[i]);
+                result[2 * i + 1] = static_cast<uint32_t>(a[i] >> 32);
+            }
+            return result;
+        }
+#endif
+    }
+
+    void mul_ntt(limb_t* r, limb_t const* a, size_t an, limb_t const* b, size_t bn)
+    {
+        assert(an + bn <= NTT_MAX_SIZE);
+#if BIGINT_LIMB_BITS == 32
+        ntt_multiply(r, a, an, b, bn);
+#else
+        std::vector<uint32_t> x = halves(a, an);
+        std::vector<uint32_t> y = a == b && an == bn ? std::vector<uint32_t>() : halves(b, bn);
+        std::vector<uint32_t> product(2 * (an + bn));
+        ntt_multiply(product.data(), x.data(), x.size(), y.empty() ? x.data() : y.data(), 2 * bn);
+        for (size_t i = 0; i < an + bn; ++i)
+        {
+            r[i] = static_cast<limb_t>(product[2 * i + 1]) << 32 | product[2 * i];
+        }
+#endif
+    }
+}
@@ -0,0 +1,202 @@
+#include "modular.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    // window width of pow_mod for an exponent of that many bits: the table of 2^(k - 1) odd powers
+    // pays off once it saves more multiplications than it costs
+    unsigned window_bits(size_t bits)
+    {
+        return bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : bits > 7 ? 2 : 1;
+    }
+}
+
+modular_context::modular_context(big_integer const& modulus)
+    : modulus_(modulus), size_(modulus.data_.size()), montgomery_(false), inverse_(0)
+{
+    if (modulus_ <= 0)
+    {
+        throw std::domain_error("modulus must be positive");
+    }
+    montgomery_ = (modulus_.data_[0] & 1) != 0;
+    if (montgomery_)
+    {
+        inverse_ = 0 - magnitude::inverse_limb(modulus_.data_[0]);
+        big_integer r_squared = (big_integer(1) << static_cast<int>(2 * size_ * magnitude::LIMB_BITS)) % modulus_;
+        r_squared_ = std::move(r_squared.data_);
+        r_squared_.resize(size_);
+    }
+}
+
+big_integer const& modular_context::modulus() const
+{
+    return modulus_;
+}
+
+big_integer modular_context::reduce(big_integer const& a) const
+{
+    if (a.compare_magnitude(modulus_) < 0 && !a.negate_)
+    {
+        return a;
+    }
+    big_integer result = a % modulus_;
+    if (result.negate_)
+    {
+        result += modulus_;
+    }
+    return result;
+}
+
+void modular_context::multiply(limb_t* r, limb_t const* a, limb_t const* b, limb_t* t) const
+{
+    size_t n = size_;
+    if (a == b)
+    {
+        magnitude::sqr(t, a, n);
+    }
+    else
+    {
+        magnitude::mul(t, a, n, b, n);
+    }
+    if (montgomery_)
+    {
+        magnitude::redc(r, t, modulus_.data_.data(), n, inverse_);
+    }
+    else
+    {
+        // the quotient is written over the product
+        magnitude::divmod(t, r, t, 2 * n, modulus_.data_.data(), n);
+    }
+}
+
+modular_context::storage modular_context::to_form(big_integer const& a, limb_t* t) const
+{
+    storage result = reduce(a).data_;
+    result.resize(size_);
+    if (montgomery_)
+    {
+        multiply(result.data(), result.data(), r_squared_.data(), t);
+    }
+    return result;
+}
+
+big_integer modular_context::from_form(limb_t const* a, limb_t* t) const
+{
+    big_integer result;
+    result.data_.assign(size_, 0);
+    if (montgomery_)
+    {
+        std::copy(a, a + size_, t);
+        std::fill(t + size_, t + 2 * size_, 0);
+        magnitude::redc(result.data_.data(), t, modulus_.data_.data(), size_, inverse_);
+    }
+    else
+    {
+        std::copy(a, a + size_, result.data_.data());
+    }
+    result.normalize();
+    return result;
+}
+
+big_integer modular_context::mul_mod(big_integer const& a, big_integer const& b) const
+{
+    // a single product is cheaper to divide than to convert in and out of the Montgomery form
+    big_integer x = reduce(a);
+    big_integer y = reduce(b);
+    if (y.is_zero())
+    {
+        return y;
+    }
+    size_t n = size_;
+    storage t(2 * n);
+    x.data_.resize(n);
+    magnitude::mul(t.data(), x.data_.data(), n, y.data_.data(), y.data_.size());
+    magnitude::divmod(t.data(), x.data_.data(), t.data(), n + y.data_.size(), modulus_.data_.data(), n);
+    x.normalize();
+    return x;
+}
+
+big_integer modular_context::pow_mod(big_integer const& base, big_integer const& exponent) const
+{
+    if (exponent.negate_)
+    {
+        return pow_mod(inverse_mod(base), -exponent);
+    }
+    size_t n = size_;
+    // every buffer is allocated here once: the product, the result and the table of odd powers
+    storage t(2 * n);
+    if (exponent.is_zero())
+    {
+        return from_form(to_form(1, t.data()).data(), t.data());
+    }
+
+    size_t bits = exponent.bit_length();
+
+    // table[i] = base^(2i + 1)
+    unsigned k = window_bits(bits);
+    size_t entries = size_t(1) << (k - 1);
+    storage table(entries * n);
+    storage x = to_form(base, t.data());
+    std::copy(x.begin(), x.end(), table.data());
+    if (entries > 1)
+    {
+        multiply(x.data(), x.data(), x.data(), t.data());
+        for (size_t i = 1; i < entries; ++i)
+        {
+            multiply(table.data() + i * n, table.data() + (i - 1) * n, x.data(), t.data());
+        }
+    }
+
+    // windows of at most k bits that start and end with a one; zero bits between them are squarings
+    bool first = true;
+    for (size_t i = bits; i != 0;)
+    {
+        --i;
+        if (!exponent.test_bit(i))
+        {
+            multiply(x.data(), x.data(), x.data(), t.data());
+            continue;
+        }
+        size_t low = i + 1 >= k ? i + 1 - k : 0;
+        while (!exponent.test_bit(low))
+        {
+            ++low;
+        }
+        size_t window = 0;
+        for (size_t j = i + 1; j != low;)
+        {
+            --j;
+            window = window << 1 | (exponent.test_bit(j) ? 1 : 0);
+            if (!first)
+            {
+                multiply(x.data(), x.data(), x.data(), t.data());
+            }
+        }
+        limb_t const* power = table.data() + (window >> 1) * n;
+        if (first)
+        {
+            std::copy(power, power + n, x.data());
+            first = false;
+        }
+        else
+        {
+            multiply(x.data(), x.data(), power, t.data());
+        }
+        i = low;
+    }
+    return from_form(x.data(), t.data());
+}
+
+big_integer modular_context::inverse_mod(big_integer const& a) const
+{
+    big_integer x;
+    big_integer y;
+    if (extended_gcd(reduce(a), modulus_, x, y) != 1)
+    {
+        throw std::domain_error("not invertible");
+    }
+    return reduce(x);
+}
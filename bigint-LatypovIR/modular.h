@@ -0,0 +1,39 @@
+#pragma once
+
+#include "big_integer.h"
+
+// Arithmetic modulo a fixed positive modulus m. An odd modulus is handled in Montgomery form
+// (x is kept as x * R mod m, R = 2^(n * LIMB_BITS) for an n-limb modulus), so products are reduced
+// without division; an even one falls back to division by m. Results are in [0, m).
+struct modular_context
+{
+    explicit modular_context(big_integer const& modulus);
+
+    big_integer const& modulus() const;
+
+    // a mod m, nonnegative
+    big_integer reduce(big_integer const& a) const;
+    // a * b mod m; a single product is reduced by division, Montgomery form pays off in pow_mod
+    big_integer mul_mod(big_integer const& a, big_integer const& b) const;
+    // base^exponent mod m by a sliding window over the bits of the exponent; a negative exponent inverts base
+    big_integer pow_mod(big_integer const& base, big_integer const& exponent) const;
+    // x with a * x = 1 (mod m); throws std::domain_error if gcd(a, m) != 1
+    big_integer inverse_mod(big_integer const& a) const;
+
+private:
+    using limb_t = magnitude::limb_t;
+    using storage = big_integer::storage;
+
+    big_integer modulus_;
+    size_t size_;
+    bool montgomery_;
+    // -m^-1 mod 2^LIMB_BITS and R^2 mod m, for an odd modulus
+    limb_t inverse_;
+    storage r_squared_;
+
+    // r[0..n) = a * b (* R^-1 in Montgomery form) mod m for a, b < m; t has 2n limbs of scratch
+    void multiply(limb_t* r, limb_t const* a, limb_t const* b, limb_t* t) const;
+    // reduced operand in the working form, padded to n limbs
+    storage to_form(big_integer const& a, limb_t* t) const;
+    big_integer from_form(limb_t const* a, limb_t* t) const;
+};
@@ -0,0 +1,181 @@
+#include "parallel.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace magnitude
+{
+    parallel_settings& parallel_execution()
+    {
+        static parallel_settings instance;
+        return instance;
+    }
+
+    namespace
+    {
+        struct task
+        {
+            std::function<void()> const* body;
+            // set under the pool mutex
+            bool done = false;
+            std::exception_ptr error;
+
+            void run()
+            {
+                try
+                {
+                    (*body)();
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+            }
+        };
+
+        class task_pool
+        {
+        public:
+            static task_pool& instance()
+            {
+                static task_pool pool;
+                return pool;
+            }
+
+            ~task_pool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stop_ = true;
+                }
+                ready_.notify_all();
+                for (std::thread& worker : workers_)
+                {
+                    worker.join();
+                }
+            }
+
+            // false if the queue is full, then the caller runs the task itself
+            bool submit(task* t, size_t threads)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (queue_.size() >= 4 * threads)
+                {
+                    return false;
+                }
+                active_ = threads - 1;
+                while (workers_.size() < active_)
+                {
+                    workers_.emplace_back(&task_pool::work, this, workers_.size());
+                }
+                queue_.push_back(t);
+                ready_.notify_all();
+                finished_.notify_all();
+                return true;
+            }
+
+            // runs queued tasks on the calling thread until t is done, sleeping while there are none
+            void wait(task const& t)
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                while (!t.done)
+                {
+                    if (queue_.empty())
+                    {
+                        finished_.wait(lock);
+                        continue;
+                    }
+                    task* next = queue_.front();
+                    queue_.pop_front();
+                    lock.unlock();
+                    next->run();
+                    lock.lock();
+                    next->done = true;
+                    finished_.notify_all();
+                }
+            }
+
+        private:
+            // workers beyond the current thread count stay asleep
+            void work(size_t index)
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                while (true)
+                {
+                    ready_.wait(lock, [this, index] { return stop_ || (!queue_.empty() && index < active_); });
+                    if (stop_)
+                    {
+                        return;
+                    }
+                    task* t = queue_.front();
+                    queue_.pop_front();
+                    lock.unlock();
+                    t->run();
+                    lock.lock();
+                    t->done = true;
+                    finished_.notify_all();
+                }
+            }
+
+            std::mutex mutex_;
+            // workers wait for tasks, forking threads for their forked task or for work to help with
+            std::condition_variable ready_;
+            std::condition_variable finished_;
+            std::deque<task*> queue_;
+            std::vector<std::thread> workers_;
+            size_t active_ = 0;
+            bool stop_ = false;
+        };
+    }
+
+    void fork_join_pooled(std::function<void()> const& f, std::function<void()> const& g)
+    {
+        task forked;
+        forked.body = &f;
+        if (!task_pool::instance().submit(&forked, parallel_execution().threads))
+        {
+            f();
+            g();
+            return;
+        }
+
+        std::exception_ptr error;
+        try
+        {
+            g();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        task_pool::instance().wait(forked);
+        if (error == nullptr)
+        {
+            error = forked.error;
+        }
+        if (error != nullptr)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    void parallel_for_pooled(size_t n, size_t parts, std::function<void(size_t, size_t)> const& body)
+    {
+        // halves are forked recursively, so that parts run as soon as a worker is free
+        std::function<void(size_t, size_t, size_t)> split = [&](size_t begin, size_t end, size_t count) {
+            if (count == 1)
+            {
+                body(begin, end);
+                return;
+            }
+            size_t half = count / 2;
+            size_t middle = begin + (end - begin) * half / count;
+            fork_join_pooled([&] { split(middle, end, count - half); }, [&] { split(begin, middle, half); });
+        };
+        split(0, n, parts);
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+
+#include "magnitude.h"
+
+// Fork-join over a bounded pool of parallel_execution().threads - 1 worker threads.
+// A thread waiting for its forked task runs queued tasks meanwhile, so nested forks cannot deadlock;
+// with threads == 1 everything runs on the calling thread.
+namespace magnitude
+{
+    void fork_join_pooled(std::function<void()> const& f, std::function<void()> const& g);
+    void parallel_for_pooled(size_t n, size_t parts, std::function<void(size_t, size_t)> const& body);
+
+    // runs f and g and returns when both are done; for operands of at least parallel_execution().threshold
+    // limbs f may run on a worker thread
+    template <typename F, typename G>
+    void fork_join(size_t size, F const& f, G const& g)
+    {
+        parallel_settings const& settings = parallel_execution();
+        if (settings.threads <= 1 || size < settings.threshold)
+        {
+            f();
+            g();
+            return;
+        }
+        fork_join_pooled(f, g);
+    }
+
+    // body(begin, end) over consecutive parts of [0, n), each of at least parallel_execution().threshold items
+    template <typename Body>
+    void parallel_for(size_t n, Body const& body)
+    {
+        parallel_settings const& settings = parallel_execution();
+        size_t parts = std::min(settings.threads, n / (settings.threshold == 0 ? 1 : settings.threshold));
+        if (parts <= 1)
+        {
+            body(0, n);
+            return;
+        }
+        parallel_for_pooled(n, parts, body);
+    }
+}
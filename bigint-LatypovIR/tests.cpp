@@ -3,9 +3,15 @@
 #include <cstdlib>
 #include <string>
 #include <limits>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 #include <gtest/gtest.h>
 
 #include "big_integer.h"
+#include "combinatorics.h"
+#include "modular.h"
+#include "benchmarks/allocation_counter.h"
 
 TEST(correctness, two_plus_two)
 {
@@ -113,6 +119,46 @@ TEST(correctness, comparisons)
     EXPECT_TRUE(d != 0);
 }
 
+TEST(correctness, comparisons_signs_and_lengths)
+{
+    big_integer large = big_integer(1) << 200;
+    big_integer values[] = {-large * 3, -large - 1, -large, -large + 1, -1, 0, 1, large - 1, large, large + 1, large * 3};
+    size_t n = sizeof(values) / sizeof(values[0]);
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            int expected = i < j ? -1 : i == j ? 0 : 1;
+            EXPECT_EQ(expected, compare(values[i], values[j]));
+            EXPECT_EQ(i == j, values[i] == values[j]);
+            EXPECT_EQ(i != j, values[i] != values[j]);
+            EXPECT_EQ(i < j, values[i] < values[j]);
+            EXPECT_EQ(i > j, values[i] > values[j]);
+            EXPECT_EQ(i <= j, values[i] <= values[j]);
+            EXPECT_EQ(i >= j, values[i] >= values[j]);
+        }
+    }
+}
+
+TEST(correctness, hash)
+{
+    std::hash<big_integer> h;
+    big_integer a("123456789012345678901234567890123456789");
+    EXPECT_EQ(h(a), h(big_integer("123456789012345678901234567890123456789")));
+    EXPECT_EQ(h(0), h(-big_integer(0)));
+    EXPECT_NE(h(a), h(-a));
+    EXPECT_NE(h(a), h(a + 1));
+
+    std::unordered_set<big_integer> set;
+    for (int i = -1000; i < 1000; ++i)
+    {
+        set.insert(a * i);
+    }
+    EXPECT_EQ(2000u, set.size());
+    EXPECT_EQ(1u, set.count(a * 999));
+    EXPECT_EQ(0u, set.count(a * 1000));
+}
+
 TEST(correctness, compare_zero_and_minus_zero)
 {
     big_integer a;
@@ -185,6 +231,165 @@ TEST(correctness, sub_return_value)
     EXPECT_EQ(3, a);
 }
 
+TEST(correctness, add_sub_carry_chain)
+{
+    for (int limbs : {1, 2, 3, 4, 5, 7, 8, 9, 33})
+    {
+        big_integer ones = (big_integer(1) << (32 * limbs)) - 1;
+        big_integer power = big_integer(1) << (32 * limbs);
+        EXPECT_EQ(power, ones + 1);
+        EXPECT_EQ(power, 1 + ones);
+        EXPECT_EQ(ones, power - 1);
+        EXPECT_EQ(power + ones, ones + ones + 1);
+        EXPECT_EQ(-ones, 1 - power);
+        EXPECT_EQ(ones + ones, ones * 2);
+    }
+}
+
+TEST(correctness, single_limb_edges)
+{
+    big_integer max = 4294967295u;
+    EXPECT_EQ(big_integer("4294967296"), max + 1);
+    EXPECT_EQ(big_integer("-4294967296"), -max - 1);
+    EXPECT_EQ(big_integer("18446744065119617025"), max * max);
+    EXPECT_EQ(big_integer("-18446744065119617025"), -max * max);
+    EXPECT_EQ(0, max - max);
+    EXPECT_EQ(0, -max + max);
+    EXPECT_EQ(-1, max - (max + 1));
+
+    big_integer a = max;
+    ++a;
+    EXPECT_EQ(big_integer("4294967296"), a);
+    --a;
+    EXPECT_EQ(max, a);
+    a = -max;
+    --a;
+    EXPECT_EQ(big_integer("-4294967296"), a);
+    ++a;
+    EXPECT_EQ(-max, a);
+    a = -1;
+    ++a;
+    EXPECT_EQ(0, a);
+    EXPECT_FALSE(a < 0);
+    --a;
+    EXPECT_EQ(-1, a);
+}
+
+TEST(correctness, inline_storage_boundary)
+{
+    // values grow from a few limbs stored inline to heap storage and shrink back
+    big_integer a = 1;
+    for (int i = 0; i < 12; ++i)
+    {
+        big_integer b = a;
+        a *= big_integer(4294967295u) * 3;
+        EXPECT_EQ(b, a / (big_integer(4294967295u) * 3));
+    }
+    big_integer large = a;
+    big_integer small = 7;
+    small = large;
+    EXPECT_EQ(large, small);
+    large = 7;
+    EXPECT_EQ(7, large);
+    EXPECT_EQ(a, small);
+    large = small;
+    large >>= 32 * 10;
+    EXPECT_EQ(a >> 320, large);
+    small %= 1000;
+    EXPECT_EQ(a % 1000, small);
+}
+
+TEST(correctness, moves_do_not_allocate)
+{
+    big_integer a = (big_integer(1) << 3200) / 3;
+    big_integer b = -(a / 7);
+    big_integer expected_sum = a + b;
+    big_integer expected_diff = b - expected_sum;
+    big_integer divisor = 1000000007;
+
+    size_t before = bench::allocation_count();
+    big_integer c = std::move(a);
+    a = std::move(c);
+    std::swap(a, b);
+    std::swap(a, b);
+    big_integer sum = std::move(a) + b;
+    big_integer diff = b - std::move(sum);
+    diff /= divisor;
+    diff %= divisor;
+    size_t allocations = bench::allocation_count() - before;
+
+    EXPECT_EQ(0u, allocations);
+    EXPECT_EQ(0, a);
+    EXPECT_EQ(0, sum);
+    EXPECT_EQ(expected_diff / divisor % divisor, diff);
+}
+
+TEST(correctness, kernel_temporaries_do_not_allocate)
+{
+    // long enough for Toom-3 and Burnikel-Ziegler, whose temporaries go to the scratch arena
+    big_integer a = (big_integer(1) << 40000) / 3;
+    big_integer b = -(a / 7);
+    big_integer divisor = (big_integer(1) << 20000) / 11;
+    big_integer expected = a * b / divisor;
+    // the buffer of x holds the product, and a first round sizes the arena
+    big_integer x = a * b;
+    x = a;
+    x *= b;
+    x /= divisor;
+
+    size_t before = bench::allocation_count();
+    x = a;
+    x *= b;
+    x /= divisor;
+    size_t allocations = bench::allocation_count() - before;
+
+    EXPECT_EQ(0u, allocations);
+    EXPECT_EQ(expected, x);
+}
+
+namespace
+{
+    struct counting_resource : magnitude::limb_resource
+    {
+        size_t allocated = 0;
+        size_t live = 0;
+
+        magnitude::limb_t* allocate(size_t n) override
+        {
+            ++allocated;
+            ++live;
+            return magnitude::default_limb_resource()->allocate(n);
+        }
+
+        void deallocate(magnitude::limb_t* p, size_t n) noexcept override
+        {
+            --live;
+            magnitude::default_limb_resource()->deallocate(p, n);
+        }
+    };
+}
+
+TEST(correctness, limb_resource)
+{
+    counting_resource resource;
+    big_integer outside = big_integer(1) << 1000;
+    {
+        magnitude::scoped_limb_resource scope(&resource);
+        EXPECT_EQ(&resource, magnitude::current_limb_resource());
+        big_integer a = big_integer(1) << 1000;
+        big_integer b = a * a + outside;
+        EXPECT_EQ((big_integer(1) << 2000) + outside, b);
+        EXPECT_NE(0u, resource.allocated);
+        // a buffer from the resource leaves the scope, the old buffer of outside goes back to the default one
+        outside = std::move(b);
+    }
+    EXPECT_EQ(magnitude::default_limb_resource(), magnitude::current_limb_resource());
+    EXPECT_EQ(1u, resource.live);
+    EXPECT_EQ((big_integer(1) << 2000) + (big_integer(1) << 1000), outside);
+    outside = 0;
+    EXPECT_EQ(0u, resource.live);
+}
+
 TEST(correctness, mul)
 {
     big_integer a = 5;
@@ -215,6 +420,39 @@ TEST(correctness, mul_return_value)
     EXPECT_EQ(20, a);
 }
 
+TEST(correctness, addmul_submul)
+{
+    big_integer a("123456789012345678901234567890");
+    big_integer b("-98765432109876543210");
+    big_integer acc("1000000000000000000000000000000000000000000000000001");
+    big_integer expected = acc + a * b;
+
+    addmul(acc, a, b);
+    EXPECT_EQ(expected, acc);
+    submul(acc, a, b);
+    submul(acc, a, b);
+    EXPECT_EQ(expected - 2 * a * b, acc);
+
+    // the sign of the accumulator flips when the product outweighs it
+    big_integer small = 5;
+    addmul(small, a, b);
+    EXPECT_EQ(5 + a * b, small);
+
+    big_integer zero;
+    submul(zero, b, b);
+    EXPECT_EQ(-b * b, zero);
+
+    big_integer self = a;
+    addmul(self, self, self);
+    EXPECT_EQ(a + a * a, self);
+
+    big_integer c = -7;
+    addmul_limb(c, a, 4294967295u);
+    EXPECT_EQ(a * big_integer(4294967295u) - 7, c);
+    addmul_limb(c, a, 0);
+    EXPECT_EQ(a * big_integer(4294967295u) - 7, c);
+}
+
 TEST(correctness, div_)
 {
     big_integer a = 20;
@@ -277,6 +515,74 @@ TEST(correctness, div_rounding_negative)
     EXPECT_TRUE(c % d == -3);
 }
 
+TEST(correctness, div_huge)
+{
+    // (2^(k*n) - 1) / (2^k - 1) = 1 + 2^k + ... + 2^(k*(n-1))
+    big_integer b = (big_integer(1) << 3001) - 1;
+    big_integer a = (big_integer(1) << (3001 * 7)) - 1;
+    big_integer q = 0;
+    for (int i = 0; i != 7; ++i)
+    {
+        q += big_integer(1) << (3001 * i);
+    }
+    EXPECT_EQ(q, a / b);
+    EXPECT_EQ(0, a % b);
+    EXPECT_EQ(q, (a + b - 1) / b);
+    EXPECT_EQ(b - 1, (a + b - 1) % b);
+    EXPECT_EQ(-q, -(a + 5) / b);
+    EXPECT_EQ(-5, -(a + 5) % b);
+    EXPECT_EQ(1, b / b);
+    EXPECT_EQ(0, b % b);
+    EXPECT_EQ(0, b / a);
+    EXPECT_EQ(-b, -b % a);
+}
+
+TEST(correctness, mod_self)
+{
+    big_integer a("-123456789012345678901234567890");
+    a %= a;
+    EXPECT_EQ(0, a);
+    big_integer b("123456789012345678901234567890");
+    b /= b;
+    EXPECT_EQ(1, b);
+}
+
+TEST(correctness, divmod)
+{
+    big_integer values[] = {big_integer(0), big_integer(7), big_integer(-7), big_integer("4294967296"),
+                            big_integer("-18446744073709551617"), big_integer("123456789012345678901234567890"),
+                            big_integer("-98765432109876543210987654321098765432109876543210")};
+    for (big_integer const& a : values)
+    {
+        for (big_integer const& b : values)
+        {
+            if (b == 0)
+            {
+                continue;
+            }
+            std::pair<big_integer, big_integer> qr = divmod(a, b);
+            EXPECT_EQ(a / b, qr.first);
+            EXPECT_EQ(a % b, qr.second);
+        }
+    }
+}
+
+TEST(correctness, divmod_small)
+{
+    big_integer a("-123456789012345678901234567890123456789");
+    EXPECT_EQ(-9, a.divmod_small(10));
+    EXPECT_EQ(big_integer("-12345678901234567890123456789012345678"), a);
+
+    big_integer b("340282366920938463463374607431768211455");
+    big_integer c = b;
+    EXPECT_EQ(b % 4294967291u, c.divmod_small(4294967291u));
+    EXPECT_EQ(b / 4294967291u, c);
+
+    big_integer d(-5);
+    EXPECT_EQ(-5, d.divmod_small(7));
+    EXPECT_EQ(0, d);
+}
+
 TEST(correctness, div_return_value)
 {
     big_integer a = 100;
@@ -286,6 +592,129 @@ TEST(correctness, div_return_value)
     EXPECT_EQ(25, a);
 }
 
+TEST(correctness, modular_context)
+{
+    // 2^127 - 1 is prime
+    big_integer p = (big_integer(1) << 127) - 1;
+    modular_context odd(p);
+    EXPECT_EQ(1, odd.pow_mod(3, p - 1));
+    EXPECT_EQ(p - 1, odd.mul_mod(-1, 1));
+    EXPECT_EQ(1, odd.mul_mod(odd.inverse_mod(12345), 12345));
+    EXPECT_EQ(odd.inverse_mod(7), odd.pow_mod(7, -1));
+    EXPECT_EQ(1, odd.pow_mod(0, 0));
+
+    modular_context even(1000000);
+    EXPECT_EQ(660001, even.pow_mod(big_integer("123456789123456789"), 1000));
+    EXPECT_EQ(999999, even.mul_mod(999999, 1));
+    EXPECT_EQ(3, even.inverse_mod(-333333));
+    EXPECT_THROW(even.inverse_mod(10), std::domain_error);
+
+    modular_context one(1);
+    EXPECT_EQ(0, one.pow_mod(5, 3));
+}
+
+TEST(correctness, combinatorics)
+{
+    EXPECT_EQ(1, product(std::vector<big_integer>()));
+    std::vector<int> values = {3, -5, 7, 11};
+    EXPECT_EQ(-1155, product(values.begin(), values.end()));
+
+    big_integer running = 1;
+    for (uint64_t n = 0; n <= 1000; ++n)
+    {
+        running *= n == 0 ? 1 : n;
+        ASSERT_EQ(running, factorial(n)) << n;
+    }
+    EXPECT_EQ(big_integer("15511210043330985984000000"), factorial(25));
+
+    EXPECT_EQ(big_integer("100891344545564193334812497256"), binomial(100, 50));
+    EXPECT_EQ(166167000, binomial(1000, 3));
+    EXPECT_EQ(binomial(1000, 997), binomial(1000, 3));
+    EXPECT_EQ(1, binomial(7, 0));
+    EXPECT_EQ(0, binomial(3, 4));
+    EXPECT_EQ(big_integer(UINT64_MAX), binomial(UINT64_MAX, 1));
+    // through the prime factorization and through the division by k!
+    EXPECT_EQ(factorial(300) / factorial(100) / factorial(200), binomial(300, 100));
+    EXPECT_EQ(factorial(300) / factorial(60) / factorial(240), binomial(300, 60));
+
+    // e = sum 1 / k!: p(k) = 1, q(k) = k
+    series_sum e = binary_splitting(0, 40, [](uint64_t k) {
+        return series_term{1, k == 0 ? 1 : big_integer(k), 1};
+    });
+    big_integer scale("1" + std::string(40, '0'));
+    EXPECT_EQ("27182818284590452353602874713526624977572", to_string(e.t * scale / e.q));
+}
+
+TEST(correctness, roots)
+{
+    EXPECT_EQ(0, isqrt(0));
+    EXPECT_EQ(1, isqrt(3));
+    EXPECT_EQ(2, isqrt(4));
+    EXPECT_EQ(2, isqrt(8));
+    EXPECT_THROW(isqrt(-1), std::domain_error);
+    big_integer x("123456789012345678901234567890123456789");
+    EXPECT_EQ(x, isqrt(x * x));
+    EXPECT_EQ(x - 1, isqrt(x * x - 1));
+    EXPECT_EQ(x, isqrt(x * x + 2 * x));
+
+    EXPECT_EQ(x, iroot(x * x * x, 3));
+    EXPECT_EQ(x - 1, iroot(x * x * x - 1, 3));
+    EXPECT_EQ(-x, iroot(-x * x * x, 3));
+    EXPECT_EQ(1, iroot(x, 1000));
+    EXPECT_EQ(x, iroot(x, 1));
+    EXPECT_EQ(2, iroot(big_integer(1) << 100, 100));
+    EXPECT_THROW(iroot(-x, 4), std::domain_error);
+    EXPECT_THROW(iroot(x, 0), std::domain_error);
+}
+
+TEST(correctness, gcd)
+{
+    EXPECT_EQ(6, gcd(12, -18));
+    EXPECT_EQ(5, gcd(0, -5));
+    EXPECT_EQ(0, gcd(0, 0));
+    EXPECT_EQ(36, lcm(-12, 18));
+    EXPECT_EQ(0, lcm(0, 7));
+
+    // consecutive Fibonacci numbers take a Euclid step per quotient of one
+    big_integer f0 = 0;
+    big_integer f1 = 1;
+    for (int i = 0; i < 3000; ++i)
+    {
+        f0 += f1;
+        std::swap(f0, f1);
+    }
+    big_integer c("1000000000000000000000000000057");
+    // operands that divide each other are reduced to zero by the first half-gcd step
+    big_integer d = (big_integer(1) << 16384) - 12345;
+    magnitude::div_thresholds saved = magnitude::division_thresholds();
+    for (size_t threshold : {size_t(2), saved.half_gcd})
+    {
+        magnitude::division_thresholds().half_gcd = threshold;
+        EXPECT_EQ(1, gcd(f0, f1));
+        EXPECT_EQ(c, gcd(f0 * c, f1 * c));
+        big_integer x, y;
+        EXPECT_EQ(c, extended_gcd(-f0 * c, f1 * c, x, y));
+        EXPECT_EQ(c, -f0 * c * x + f1 * c * y);
+        EXPECT_LE(x < 0 ? -x : x, f1 / 2);
+
+        EXPECT_EQ(d, gcd(d, d));
+        EXPECT_EQ(d, gcd(-d, d * 3));
+        EXPECT_EQ(d, extended_gcd(d, -d, x, y));
+        EXPECT_EQ(d, d * x - d * y);
+        EXPECT_EQ(d, extended_gcd(d, d * 5, x, y));
+        EXPECT_EQ(d, d * x + d * 5 * y);
+    }
+    magnitude::division_thresholds() = saved;
+
+    big_integer x, y;
+    EXPECT_EQ(4, extended_gcd(-4, 0, x, y));
+    EXPECT_EQ(-1, x);
+    EXPECT_EQ(0, y);
+    EXPECT_EQ(3, extended_gcd(0, 3, x, y));
+    EXPECT_EQ(0, x);
+    EXPECT_EQ(1, y);
+}
+
 TEST(correctness, unary_plus)
 {
     big_integer a = 123;
@@ -507,6 +936,54 @@ TEST(correctness, shr_return_value)
     EXPECT_EQ(8, a);
 }
 
+TEST(correctness, shifts_limb_aligned)
+{
+    big_integer a("-123456789012345678901234567890");
+    EXPECT_EQ(a * (big_integer(1) << 128), a << 128);
+    EXPECT_EQ(a, (a << 128) >> 128);
+    EXPECT_EQ(a / (big_integer(1) << 64) - 1, a >> 64);
+    EXPECT_EQ(-1, a >> 1000);
+    EXPECT_EQ(0, -a >> 1000);
+    EXPECT_EQ(-(big_integer(1) << 64), -(big_integer(1) << 128) >> 64);
+}
+
+TEST(correctness, bit_helpers)
+{
+    big_integer a = (big_integer(1) << 100) + 5;
+    EXPECT_EQ(101u, a.bit_length());
+    EXPECT_EQ(101u, (-a).bit_length());
+    EXPECT_EQ(0u, big_integer(0).bit_length());
+    EXPECT_EQ(3u, a.popcount());
+    EXPECT_TRUE(a.test_bit(100));
+    EXPECT_TRUE(a.test_bit(2));
+    EXPECT_FALSE(a.test_bit(1));
+    EXPECT_FALSE(a.test_bit(1000));
+
+    // bits of negative values are those of the two's complement, as in operator&
+    big_integer b("-340282366920938463463374607431768211456");
+    for (size_t i : {0, 31, 64, 127, 128, 129, 200})
+    {
+        EXPECT_EQ(((b >> static_cast<int>(i)) & 1) != 0, b.test_bit(i));
+        EXPECT_EQ(((-a >> static_cast<int>(i)) & 1) != 0, (-a).test_bit(i));
+    }
+
+    big_integer c = a;
+    c.set_bit(64);
+    EXPECT_EQ(a + (big_integer(1) << 64), c);
+    c.set_bit(64, false);
+    c.set_bit(0, false);
+    EXPECT_EQ(a - 1, c);
+
+    big_integer d = -a;
+    d.set_bit(1);
+    EXPECT_EQ(-a | 2, d);
+    d.set_bit(300, false);
+    EXPECT_EQ((-a | 2) & ~(big_integer(1) << 300), d);
+    big_integer e = -1;
+    e.set_bit(5, false);
+    EXPECT_EQ(-33, e);
+}
+
 TEST(correctness, add_long)
 {
     big_integer a("10000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000");
@@ -600,6 +1077,79 @@ TEST(correctness, mul_long_pow2)
     EXPECT_EQ(c, b * b);
 }
 
+TEST(correctness, mul_huge)
+{
+    big_integer one = 1;
+    big_integer a = (one << 25001) - 1;
+    big_integer b = (one << 12345) - 1;
+    big_integer c = (one << 3001) - 1;
+
+    EXPECT_EQ((one << 50002) - (one << 25002) + 1, a * a);
+    EXPECT_EQ((one << 37346) - (one << 25001) - (one << 12345) + 1, a * b);
+    EXPECT_EQ((one << 28002) - (one << 25001) - (one << 3001) + 1, a * c);
+    EXPECT_EQ(-(a * b), a * -b);
+}
+
+TEST(correctness, square)
+{
+    big_integer a("-100000000000000000000000000");
+    big_integer c( "100000000000000000000000000"
+                    "00000000000000000000000000");
+
+    EXPECT_EQ(c, square(a));
+    EXPECT_EQ(c, square(-a));
+    EXPECT_EQ(0, square(big_integer()));
+
+    big_integer one = 1;
+    big_integer d = (one << 25001) - 3;
+    EXPECT_EQ((one << 50002) - (big_integer(3) << 25002) + 9, square(d));
+}
+
+
+TEST(correctness, parallel_execution)
+{
+    big_integer one = 1;
+    big_integer a = (one << 200000) / 7 - 12345;
+    big_integer b = -((one << 150000) / 13);
+    big_integer product = a * b;
+    std::string decimal = to_string(product);
+
+    // a low threshold splits Karatsuba, Toom-3, the transforms and the conversions between threads
+    magnitude::parallel_settings saved = magnitude::parallel_execution();
+    magnitude::mul_thresholds saved_mul = magnitude::thresholds();
+    magnitude::parallel_execution().threads = 4;
+    magnitude::parallel_execution().threshold = 64;
+    for (size_t ntt : {size_t(1000), saved_mul.ntt})
+    {
+        magnitude::thresholds().ntt = ntt;
+        EXPECT_EQ(product, a * b);
+        EXPECT_EQ(square(a), a * big_integer(a));
+    }
+    EXPECT_EQ(decimal, to_string(product));
+    EXPECT_EQ(product, big_integer(decimal));
+    magnitude::thresholds() = saved_mul;
+    magnitude::parallel_execution() = saved;
+}
+
+TEST(correctness, parallel_conversions)
+{
+    // both threads extend the cache of decimal powers while the pool runs their forked halves
+    magnitude::parallel_settings saved = magnitude::parallel_execution();
+    magnitude::parallel_execution().threads = 4;
+    magnitude::parallel_execution().threshold = 64;
+    big_integer a = (big_integer(1) << 420000) / 3;
+    std::string b_decimal(110000, '7');
+    std::string a_decimal;
+    big_integer b;
+    std::thread printer([&] { a_decimal = to_string(a); });
+    std::thread parser([&] { b = big_integer(b_decimal); });
+    printer.join();
+    parser.join();
+    magnitude::parallel_execution() = saved;
+
+    EXPECT_EQ(a, big_integer(a_decimal));
+    EXPECT_EQ(b_decimal, to_string(b));
+}
 
 TEST(correctness, div_long)
 {
@@ -679,6 +1229,97 @@ TEST(correctness, string_conv)
     EXPECT_EQ("-2147483649", to_string(lim));
 }
 
+TEST(correctness, string_conv_long)
+{
+    std::string nines(5000, '9');
+    big_integer a(nines);
+    EXPECT_EQ(nines, to_string(a));
+    EXPECT_EQ("1" + std::string(5000, '0'), to_string(a + 1));
+    EXPECT_EQ("-1" + std::string(4999, '0') + "1", to_string(-a - 2));
+
+    std::string digits;
+    for (size_t i = 0; i != 20000; ++i)
+    {
+        digits += static_cast<char>('0' + (i * i + i / 7) % 10);
+    }
+    digits[0] = '7';
+    big_integer b(digits);
+    EXPECT_EQ(digits, to_string(b));
+    EXPECT_EQ("-" + digits, to_string(-b));
+    EXPECT_EQ(digits, to_string(big_integer("000" + digits)));
+    EXPECT_EQ(b * b, big_integer(to_string(b * b)));
+}
+
+TEST(correctness, string_conv_radix)
+{
+    EXPECT_EQ("ff", to_string(big_integer(255), 16));
+    EXPECT_EQ("-11111111", to_string(big_integer(-255), 2));
+    EXPECT_EQ("377", to_string(big_integer(255), 8));
+    EXPECT_EQ("0", to_string(big_integer(), 16));
+    EXPECT_EQ("123", to_string(big_integer(123), 10));
+    EXPECT_EQ("100000000000000000000000000000000", to_string(big_integer(1) << 128, 16));
+
+    EXPECT_EQ(big_integer(255), big_integer("FF", 16));
+    EXPECT_EQ(big_integer(-255), big_integer("-0ff", 16));
+    EXPECT_EQ(big_integer(5), big_integer("+101", 2));
+    EXPECT_EQ(big_integer(1) << 100, big_integer("1" + std::string(20, '0'), 32));
+    EXPECT_EQ(big_integer("123456789012345678901234567890"),
+              big_integer("18ee90ff6c373e0ee4e3f0ad2", 16));
+
+    EXPECT_THROW(big_integer("12", 2), std::invalid_argument);
+    EXPECT_THROW(big_integer("g", 16), std::invalid_argument);
+    EXPECT_THROW(big_integer("-", 16), std::invalid_argument);
+    EXPECT_THROW(big_integer("10", 3), std::invalid_argument);
+    EXPECT_THROW(to_string(big_integer(10), 7), std::invalid_argument);
+}
+
+TEST(correctness, binary_conv)
+{
+    big_integer a("102030405060708090a0b0c0d0e0f1011", 16);
+    std::vector<unsigned char> big = to_bytes(a, byte_order::big_endian);
+    ASSERT_EQ(17u, big.size());
+    for (size_t i = 0; i < big.size(); ++i)
+    {
+        EXPECT_EQ(i + 1, big[i]);
+    }
+    std::vector<unsigned char> little = to_bytes(-a, byte_order::little_endian);
+    EXPECT_EQ(std::vector<unsigned char>(big.rbegin(), big.rend()), little);
+    EXPECT_EQ(a, big_integer(big.data(), big.size(), byte_order::big_endian));
+    EXPECT_EQ(-a, big_integer(little.data(), little.size(), byte_order::little_endian, true));
+
+    std::vector<uint32_t> words = to_words(a);
+    EXPECT_EQ((std::vector<uint32_t>{0x0e0f1011, 0x0a0b0c0d, 0x06070809, 0x02030405, 0x01}), words);
+    EXPECT_EQ(-a, big_integer(words.data(), words.size(), true));
+
+    // leading zeros are dropped, zero has no sign
+    unsigned char const padded[] = {0, 0, 1, 0};
+    EXPECT_EQ(256, big_integer(padded, 4, byte_order::big_endian));
+    EXPECT_EQ(1 << 16, big_integer(padded, 4, byte_order::little_endian));
+    uint32_t const zeros[] = {0, 0, 0};
+    EXPECT_EQ(0, big_integer(zeros, 3, true));
+    EXPECT_FALSE(big_integer(zeros, 3, true) < 0);
+    EXPECT_EQ(0, big_integer(zeros, 0));
+    EXPECT_TRUE(to_bytes(big_integer(), byte_order::big_endian).empty());
+    EXPECT_TRUE(to_words(big_integer()).empty());
+
+    big_integer b = (big_integer(1) << 1000) - 1;
+    EXPECT_EQ(125u, to_bytes(b, byte_order::little_endian).size());
+    EXPECT_EQ(32u, to_words(b).size());
+
+    // the view covers the magnitude, least significant limb first
+    big_integer negative_b = -b;
+    big_integer::limb_view view = negative_b.limbs();
+    EXPECT_EQ((1000 + magnitude::LIMB_BITS - 1) / magnitude::LIMB_BITS, view.size());
+    big_integer c;
+    for (size_t i = view.size(); i-- > 0;)
+    {
+        c <<= static_cast<int>(magnitude::LIMB_BITS);
+        c += big_integer(static_cast<unsigned long long>(view[i]));
+    }
+    EXPECT_EQ(b, c);
+    EXPECT_EQ(0u, big_integer().limbs().size());
+}
+
 namespace
 {
     template <typename T>
@@ -2,7 +2,21 @@
 // Created by Ildar on 01.06.2021.
 //
 
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
 #include <memory>
+#include <new>
+#include <type_traits>
+
+// Objects of a trivially relocatable type may be moved to another address by copying their bytes, without
+// calling the move constructor and the destructor. Trivially copyable types are, others may be declared so
+// by specializing the trait; it has its own namespace, so that it does not clash with the one of vector.
+namespace socow_traits {
+    template<typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+}
 
 template<typename T, size_t SMALL_SIZE>
 struct socow_vector {
@@ -10,9 +24,10 @@ struct socow_vector {
     using iterator = T *;
     using const_iterator = T const *;
 
-    socow_vector() : size_(0) {};
+    // big_data starts out null, so that no path reads an uninitialized pointer
+    socow_vector() : big_data(nullptr), size_(0) {};
 
-    socow_vector(socow_vector const &other) : size_(other.size() << 1) {
+    socow_vector(socow_vector const &other) : big_data(nullptr), size_(other.size() << 1) {
         // WARNING : other.size_ is bad, now we small vector
         if (other.small()) {
             copy_array(data(), other.data(), size());
@@ -75,9 +90,8 @@ struct socow_vector {
 
     void push_back(T const &obj) {
         if (size() == capacity()) {
-            T tmp_obj = obj;
-            ensure_capacity(capacity() == 0 ? 1 : capacity() * 2);
-            new(data() + size()) T(tmp_obj);
+            // obj may be an element, so it is copied before the elements move
+            ensure_capacity(capacity() == 0 ? 1 : capacity() * 2, &obj);
         } else {
             new(data() + size()) T(obj);
         }
@@ -130,7 +144,7 @@ struct socow_vector {
 
         if (--(copy->counter) == 0) {
             clear_array(copy->array, size());
-            operator delete(copy);
+            free_storage(copy);
         }
 
     };
@@ -190,8 +204,16 @@ struct socow_vector {
     iterator insert(const_iterator pos, T const &obj) {
         size_t index = pos - const_data();
         push_back(obj); // auto update
-        for (size_t i = size() - 1; i != index; --i) {
-            std::swap(data()[i], data()[i - 1]);
+        if constexpr (socow_traits::is_trivially_relocatable<T>::value) {
+            T *arr = data();
+            alignas(T) unsigned char last[sizeof(T)];
+            std::memcpy(last, static_cast<void *>(arr + size() - 1), sizeof(T));
+            std::memmove(static_cast<void *>(arr + index + 1), arr + index, (size() - 1 - index) * sizeof(T));
+            std::memcpy(static_cast<void *>(arr + index), last, sizeof(T));
+        } else {
+            for (size_t i = size() - 1; i != index; --i) {
+                std::swap(data()[i], data()[i - 1]);
+            }
         }
         return begin() + index;
     };
@@ -206,6 +228,15 @@ struct socow_vector {
 
         make_copy();
 
+        if constexpr (socow_traits::is_trivially_relocatable<T>::value) {
+            T *arr = data();
+            clear_array(arr + start, count);
+            std::memmove(static_cast<void *>(arr + start), arr + start + count,
+                         (size() - start - count) * sizeof(T));
+            size_ -= count << 1;
+            return begin() + start;
+        }
+
         for (size_t i = start; i + count != size(); i++) {
             std::swap(data()[i], data()[i + count]);
         }
@@ -218,21 +249,61 @@ struct socow_vector {
     };
 
 private:
-    void ensure_capacity(size_t new_capacity_) {
+    // with obj, also constructs a copy of *obj after the elements, which is not counted in the size
+    void ensure_capacity(size_t new_capacity_, T const *obj = nullptr) {
         if (small() && new_capacity_ <= SMALL_SIZE) {
             return;
         }
-        // size_t capacity + T* array
+        if constexpr (uses_realloc) {
+            if (!small() && unique()) {
+                // nobody else sees the buffer, realloc moves it with the elements, possibly in place;
+                // the copy of *obj waits aside
+                alignas(T) unsigned char copy[sizeof(T)];
+                if (obj != nullptr) {
+                    new(copy) T(*obj);
+                }
+                void *moved = std::realloc(static_cast<void *>(big_data), storage_bytes(new_capacity_));
+                if (moved == nullptr) {
+                    if (obj != nullptr) {
+                        reinterpret_cast<T *>(copy)->~T();
+                    }
+                    throw std::bad_alloc();
+                }
+                big_data = static_cast<dynamic_storage *>(moved);
+                big_data->capacity = new_capacity_;
+                if (obj != nullptr) {
+                    std::memcpy(static_cast<void *>(big_data->array + size()), copy, sizeof(T));
+                }
+                return;
+            }
+        }
 
-        dynamic_storage *new_storage =
-                reinterpret_cast<dynamic_storage*>(operator new(new_capacity_ * sizeof(T) + sizeof(dynamic_storage)));
-        new_storage->capacity = new_capacity_;
-        new_storage->counter = 0;
+        dynamic_storage *new_storage = allocate_storage(new_capacity_);
+        if (obj != nullptr) {
+            try {
+                new(new_storage->array + size()) T(*obj);
+            } catch (...) {
+                free_storage(new_storage);
+                throw;
+            }
+        }
+
+        if (socow_traits::is_trivially_relocatable<T>::value && unique()) {
+            // the elements change their address, the old copies are not destroyed
+            if (size() != 0) {
+                std::memcpy(static_cast<void *>(new_storage->array), const_data(), size() * sizeof(T));
+            }
+            toBigType(new_storage);
+            return;
+        }
 
         try {
             copy_array(new_storage->array, const_data(), size());
         } catch (...) {
-            operator delete(new_storage);
+            if (obj != nullptr) {
+                new_storage->array[size()].~T();
+            }
+            free_storage(new_storage);
             throw;
         }
 
@@ -243,12 +314,20 @@ private:
     };
 
     void clear_array(T *arr, size_t cnt) {
-        while (cnt > 0) {
-            arr[--cnt].~T();
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            while (cnt > 0) {
+                arr[--cnt].~T();
+            }
         }
     }
 
     void copy_array(T *result, T const *arr, size_t cnt) {
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            if (cnt != 0) {
+                std::memcpy(result, arr, cnt * sizeof(T));
+            }
+            return;
+        }
         for (size_t i = 0; i != cnt; ++i) {
             try {
                 new(result + i) T(arr[i]);
@@ -272,6 +351,39 @@ private:
         T array[];
     };
 
+    // storage of trivially relocatable elements comes from malloc, so that it can grow with realloc
+    static constexpr bool uses_realloc =
+            socow_traits::is_trivially_relocatable<T>::value && alignof(T) <= alignof(std::max_align_t);
+
+    static size_t storage_bytes(size_t capacity) {
+        // size_t counter + size_t capacity + T array[capacity]
+        return capacity * sizeof(T) + sizeof(dynamic_storage);
+    }
+
+    static dynamic_storage *allocate_storage(size_t capacity) {
+        void *memory;
+        if constexpr (uses_realloc) {
+            memory = std::malloc(storage_bytes(capacity));
+            if (memory == nullptr) {
+                throw std::bad_alloc();
+            }
+        } else {
+            memory = operator new(storage_bytes(capacity));
+        }
+        dynamic_storage *storage = static_cast<dynamic_storage *>(memory);
+        storage->capacity = capacity;
+        storage->counter = 0;
+        return storage;
+    }
+
+    static void free_storage(dynamic_storage *storage) {
+        if constexpr (uses_realloc) {
+            std::free(storage);
+        } else {
+            operator delete(storage);
+        }
+    }
+
     union {
         T small_data[SMALL_SIZE];
         dynamic_storage* big_data;
@@ -286,7 +398,7 @@ private:
     void toSmallType() {
         if (!small()) {
             if (--(big_data->counter) == 0) {
-                operator delete(big_data);
+                free_storage(big_data);
             }
             size_ = (size_ >> 1) << 1;
         }
@@ -295,7 +407,7 @@ private:
     void toBigType(dynamic_storage* other) {
         if (!small()) {
             if (--(big_data->counter) == 0) {
-                operator delete(big_data);
+                free_storage(big_data);
             }
         }
         big_data = other;
@@ -1,4 +1,6 @@
+#include <memory>
 #include <unordered_set>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -1314,3 +1316,103 @@ TEST(small_object, erase_big_into_small_3) {
     EXPECT_THROW(a.erase(as_const(a).begin() + 2, as_const(a).end() - 1),
                  std::runtime_error);
 }
+
+// Holds a shared value; declared trivially relocatable, so the vector moves it by copying bytes.
+struct shared_box {
+    static size_t instances;
+
+    shared_box(size_t val) : ptr(std::make_shared<size_t>(val)) {
+        ++instances;
+    }
+
+    shared_box(shared_box const& rhs) : ptr(rhs.ptr) {
+        ++instances;
+    }
+
+    shared_box& operator=(shared_box const& rhs) = default;
+
+    ~shared_box() {
+        --instances;
+    }
+
+    std::shared_ptr<size_t> ptr;
+};
+
+size_t shared_box::instances = 0;
+
+template <>
+struct socow_traits::is_trivially_relocatable<shared_box> : std::true_type {};
+
+template <typename T, typename Get>
+void check_relocation(Get get) {
+    size_t const N = 500;
+    socow_vector<T, 3> a;
+    std::vector<size_t> expected;
+    for (size_t i = 0; i != N; ++i) {
+        size_t index = i * 7 % (a.size() + 1);
+        a.insert(as_const(a).begin() + index, T(i));
+        expected.insert(expected.begin() + index, i);
+    }
+    a.insert(as_const(a).begin() + 3, as_const(a)[N / 2]);
+    expected.insert(expected.begin() + 3, expected[N / 2]);
+
+    socow_vector<T, 3> b = a;
+    std::vector<size_t> b_expected = expected;
+
+    a.erase(as_const(a).begin() + 10, as_const(a).begin() + 110);
+    expected.erase(expected.begin() + 10, expected.begin() + 110);
+    a.erase(as_const(a).begin());
+    expected.erase(expected.begin());
+    a.shrink_to_fit();
+    b.push_back(as_const(b)[0]);
+    b_expected.push_back(b_expected[0]);
+    b.erase(as_const(b).end() - 300, as_const(b).end());
+    b_expected.erase(b_expected.end() - 300, b_expected.end());
+    b.reserve(1000);
+
+    ASSERT_EQ(expected.size(), a.size());
+    for (size_t i = 0; i != expected.size(); ++i)
+        EXPECT_EQ(expected[i], get(as_const(a)[i]));
+    ASSERT_EQ(b_expected.size(), b.size());
+    for (size_t i = 0; i != b_expected.size(); ++i)
+        EXPECT_EQ(b_expected[i], get(as_const(b)[i]));
+
+    a.erase(as_const(a).begin() + 2, as_const(a).end());
+    a.shrink_to_fit();
+    EXPECT_EQ(3, a.capacity());
+    EXPECT_EQ(expected[1], get(as_const(a)[1]));
+}
+
+TEST(trivially_relocatable, trait) {
+    EXPECT_TRUE(socow_traits::is_trivially_relocatable<size_t>::value);
+    EXPECT_TRUE(socow_traits::is_trivially_relocatable<shared_box>::value);
+    EXPECT_FALSE(socow_traits::is_trivially_relocatable<element<size_t>>::value);
+}
+
+TEST(trivially_relocatable, trivially_copyable) {
+    check_relocation<size_t>([](size_t x) { return x; });
+}
+
+TEST(trivially_relocatable, declared) {
+    check_relocation<shared_box>([](shared_box const& x) { return *x.ptr; });
+    EXPECT_EQ(0, shared_box::instances);
+}
+
+TEST(trivially_relocatable, shared_growth) {
+    size_t const N = 500;
+    {
+        socow_vector<shared_box, 3> a;
+        for (size_t i = 0; i != N; ++i)
+            a.push_back(i);
+        socow_vector<shared_box, 3> b = a;
+        for (size_t i = 0; i != N; ++i)
+            b.push_back(as_const(b)[i]);
+        EXPECT_EQ(3, as_const(a)[0].ptr.use_count());
+        EXPECT_EQ(N, a.size());
+        EXPECT_EQ(2 * N, b.size());
+        for (size_t i = 0; i != 2 * N; ++i)
+            EXPECT_EQ(i % N, *as_const(b)[i].ptr);
+        EXPECT_EQ(3 * N, shared_box::instances);
+    }
+    EXPECT_EQ(0, shared_box::instances);
+}
@@ -0,0 +1,325 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+// Monotonic memory for data that lives as long as a request: an allocation
+// bumps a pointer in the current chunk, deallocation does nothing, and the
+// memory goes back all at once. Single-threaded.
+struct arena {
+  explicit arena(size_t first_chunk = 4096) noexcept
+      : chunk_(nullptr), used_(0), next_size_(first_chunk), reserved_(0) {}
+
+  arena(arena const&) = delete;
+  arena& operator=(arena const&) = delete;
+
+  ~arena() {
+    release();
+  }
+
+  // alignment is at most alignof(std::max_align_t)
+  void* allocate(size_t bytes, size_t alignment) {
+    assert(alignment <= alignof(std::max_align_t));
+    size_t offset = (used_ + alignment - 1) & ~(alignment - 1);
+    if (chunk_ == nullptr || offset > chunk_->size ||
+        bytes > chunk_->size - offset) {
+      add_chunk(bytes);
+      offset = 0;
+    }
+    used_ = offset + bytes;
+    return chunk_->data() + offset;
+  }
+
+  // Lets the block of bytes at p hold wanted bytes without moving it: the
+  // last block allocated can take the rest of its chunk, and any block can
+  // shrink. Returns false if it cannot.
+  bool resize(void* p, size_t bytes, size_t wanted) noexcept {
+    unsigned char* block = static_cast<unsigned char*>(p);
+    if (chunk_ != nullptr && block + bytes == chunk_->data() + used_) {
+      size_t offset = block - chunk_->data();
+      if (wanted <= chunk_->size - offset) {
+        used_ = offset + wanted;
+        return true;
+      }
+    }
+    return wanted <= bytes;
+  }
+
+  // frees everything but the last chunk, the largest one, and starts over in
+  // it: a request-scoped arena stops allocating once it has seen the largest
+  // request
+  void reset() noexcept {
+    if (chunk_ != nullptr) {
+      free_chunks(chunk_->previous);
+      chunk_->previous = nullptr;
+      reserved_ = chunk_->size;
+    }
+    used_ = 0;
+  }
+
+  // gives all the memory back
+  void release() noexcept {
+    free_chunks(chunk_);
+    chunk_ = nullptr;
+    used_ = 0;
+    reserved_ = 0;
+  }
+
+  // bytes taken from operator new
+  size_t reserved() const noexcept {
+    return reserved_;
+  }
+
+private:
+  struct alignas(std::max_align_t) chunk {
+    chunk* previous;
+    size_t size;
+
+    unsigned char* data() noexcept {
+      return reinterpret_cast<unsigned char*>(this + 1);
+    }
+  };
+
+  void add_chunk(size_t bytes) {
+    size_t size = next_size_;
+    while (size < bytes) {
+      size *= 2;
+    }
+    chunk* c = static_cast<chunk*>(operator new(sizeof(chunk) + size));
+    c->previous = chunk_;
+    c->size = size;
+    chunk_ = c;
+    next_size_ = size * 2;
+    reserved_ += size;
+  }
+
+  static void free_chunks(chunk* c) noexcept {
+    while (c != nullptr) {
+      chunk* previous = c->previous;
+      operator delete(c);
+      c = previous;
+    }
+  }
+
+  chunk* chunk_;
+  size_t used_;
+  size_t next_size_;
+  size_t reserved_;
+};
+
+// Allocator over an arena. Containers keep the arena they were created with:
+// the allocator does not propagate on assignment or swap.
+template <typename T>
+struct arena_allocator {
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+                "arena chunks are aligned as std::max_align_t");
+
+  using value_type = T;
+
+  explicit arena_allocator(arena& a) noexcept : arena_(&a) {}
+
+  template <typename U>
+  arena_allocator(arena_allocator<U> const& other) noexcept
+      : arena_(other.arena_) {}
+
+  T* allocate(size_t n) {
+    if (n > SIZE_MAX / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, size_t) noexcept {}
+
+  size_t resize_in_place(T* p, size_t n, size_t wanted) noexcept {
+    if (wanted > SIZE_MAX / sizeof(T) ||
+        !arena_->resize(p, n * sizeof(T), wanted * sizeof(T))) {
+      return 0;
+    }
+    return wanted;
+  }
+
+  friend bool operator==(arena_allocator const& a,
+                         arena_allocator const& b) noexcept {
+    return a.arena_ == b.arena_;
+  }
+
+  friend bool operator!=(arena_allocator const& a,
+                         arena_allocator const& b) noexcept {
+    return a.arena_ != b.arena_;
+  }
+
+private:
+  template <typename U>
+  friend struct arena_allocator;
+
+  arena* arena_;
+};
+
+// Size-class pool: requests up to MAX_BLOCK bytes are rounded up to a power of
+// two and served from free lists of such blocks, which are carved from slabs
+// and reused after deallocation; larger requests go to operator new. The slabs
+// are freed with the pool. Single-threaded.
+struct pool {
+  static constexpr size_t MIN_BLOCK = 16;
+  static constexpr size_t MAX_BLOCK = size_t(1) << 16;
+
+  pool() noexcept : slabs_(nullptr), free_(), in_use_(0) {}
+
+  pool(pool const&) = delete;
+  pool& operator=(pool const&) = delete;
+
+  ~pool() {
+    while (slabs_ != nullptr) {
+      slab* next = slabs_->next;
+      operator delete(slabs_);
+      slabs_ = next;
+    }
+  }
+
+  void* allocate(size_t bytes) {
+    if (bytes > MAX_BLOCK) {
+      void* result = operator new(bytes);
+      in_use_ += bytes;
+      return result;
+    }
+    size_t c = size_class(bytes);
+    if (free_[c] == nullptr) {
+      add_slab(c);
+    }
+    block* b = free_[c];
+    free_[c] = b->next;
+    in_use_ += MIN_BLOCK << c;
+    return b;
+  }
+
+  void deallocate(void* p, size_t bytes) noexcept {
+    if (bytes > MAX_BLOCK) {
+      operator delete(p);
+      in_use_ -= bytes;
+      return;
+    }
+    size_t c = size_class(bytes);
+    block* b = static_cast<block*>(p);
+    b->next = free_[c];
+    free_[c] = b;
+    in_use_ -= MIN_BLOCK << c;
+  }
+
+  // A block holds the whole of its size class, so it can take up to that many
+  // bytes without moving; a block that would move to another class cannot be
+  // resized. Returns the bytes the block of bytes holds for wanted ones, or 0.
+  size_t resize(size_t bytes, size_t wanted) const noexcept {
+    if (bytes > MAX_BLOCK || wanted > MAX_BLOCK ||
+        size_class(wanted) != size_class(bytes)) {
+      return 0;
+    }
+    return MIN_BLOCK << size_class(bytes);
+  }
+
+  // bytes handed out and not yet given back, with the rounding
+  size_t in_use() const noexcept {
+    return in_use_;
+  }
+
+private:
+  static constexpr size_t CLASSES = 13;
+  static_assert(MIN_BLOCK << (CLASSES - 1) == MAX_BLOCK,
+                "a class for every power of two from MIN_BLOCK to MAX_BLOCK");
+  // a slab holds that many bytes of blocks, or at least MIN_BLOCKS blocks
+  static constexpr size_t SLAB_BYTES = size_t(1) << 16;
+  static constexpr size_t MIN_BLOCKS = 4;
+
+  struct block {
+    block* next;
+  };
+
+  struct alignas(std::max_align_t) slab {
+    slab* next;
+  };
+
+  static size_t size_class(size_t bytes) noexcept {
+    size_t c = 0;
+    while ((MIN_BLOCK << c) < bytes) {
+      ++c;
+    }
+    return c;
+  }
+
+  void add_slab(size_t c) {
+    size_t block_size = MIN_BLOCK << c;
+    size_t count = SLAB_BYTES / block_size;
+    if (count < MIN_BLOCKS) {
+      count = MIN_BLOCKS;
+    }
+    slab* s =
+        static_cast<slab*>(operator new(sizeof(slab) + count * block_size));
+    s->next = slabs_;
+    slabs_ = s;
+    unsigned char* blocks = reinterpret_cast<unsigned char*>(s + 1);
+    for (size_t i = count; i-- > 0;) {
+      block* b = reinterpret_cast<block*>(blocks + i * block_size);
+      b->next = free_[c];
+      free_[c] = b;
+    }
+  }
+
+  slab* slabs_;
+  block* free_[CLASSES];
+  size_t in_use_;
+};
+
+// Allocator over a pool. It is a handle to a shared pool, so containers take
+// it along on assignment and swap.
+template <typename T>
+struct pool_allocator {
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+                "pool blocks are aligned as std::max_align_t");
+
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  explicit pool_allocator(pool& p) noexcept : pool_(&p) {}
+
+  template <typename U>
+  pool_allocator(pool_allocator<U> const& other) noexcept
+      : pool_(other.pool_) {}
+
+  T* allocate(size_t n) {
+    if (n > SIZE_MAX / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    return static_cast<T*>(pool_->allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, size_t n) noexcept {
+    pool_->deallocate(p, n * sizeof(T));
+  }
+
+  size_t resize_in_place(T*, size_t n, size_t wanted) noexcept {
+    if (wanted > SIZE_MAX / sizeof(T)) {
+      return 0;
+    }
+    return pool_->resize(n * sizeof(T), wanted * sizeof(T)) / sizeof(T);
+  }
+
+  friend bool operator==(pool_allocator const& a,
+                         pool_allocator const& b) noexcept {
+    return a.pool_ == b.pool_;
+  }
+
+  friend bool operator!=(pool_allocator const& a,
+                         pool_allocator const& b) noexcept {
+    return a.pool_ != b.pool_;
+  }
+
+private:
+  template <typename U>
+  friend struct pool_allocator;
+
+  pool* pool_;
+};
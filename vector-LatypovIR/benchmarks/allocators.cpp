@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "../allocators.h"
+#include "../vector.h"
+
+// A request builds a few dozen vectors of random sizes, grown element by
+// element, some of them nested, and drops them all at the end; the same
+// request with std::allocator, with an arena reset after every request and
+// with a pool.
+namespace {
+size_t const VECTORS = 64;
+
+std::vector<size_t> request_sizes(size_t max_size) {
+  std::mt19937 rng(42);
+  std::vector<size_t> sizes;
+  for (size_t i = 0; i != VECTORS; ++i) {
+    sizes.push_back(1 + rng() % max_size);
+  }
+  return sizes;
+}
+
+template <typename Allocator>
+size_t handle_request(std::vector<size_t> const& sizes,
+                      Allocator const& alloc) {
+  using inner_t = vector<int, Allocator>;
+  using outer_alloc_t =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<inner_t>;
+  vector<inner_t, outer_alloc_t> rows{outer_alloc_t(alloc)};
+  for (size_t size : sizes) {
+    rows.emplace_back(alloc);
+    for (size_t i = 0; i != size; ++i) {
+      rows.back().push_back(static_cast<int>(i));
+    }
+  }
+  size_t total = 0;
+  for (size_t i = 0; i != rows.size(); ++i) {
+    total += rows[i].size();
+  }
+  return total;
+}
+
+// range(0): the largest vector of a request
+void BM_request_std(benchmark::State& state) {
+  std::vector<size_t> sizes = request_sizes(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(handle_request(sizes, std::allocator<int>()));
+  }
+}
+
+void BM_request_arena(benchmark::State& state) {
+  std::vector<size_t> sizes = request_sizes(state.range(0));
+  arena memory;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        handle_request(sizes, arena_allocator<int>(memory)));
+    memory.reset();
+  }
+  state.counters["reserved"] = static_cast<double>(memory.reserved());
+}
+
+void BM_request_pool(benchmark::State& state) {
+  std::vector<size_t> sizes = request_sizes(state.range(0));
+  pool memory;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(handle_request(sizes, pool_allocator<int>(memory)));
+  }
+}
+} // namespace
+
+BENCHMARK(BM_request_std)->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK(BM_request_arena)->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK(BM_request_pool)->RangeMultiplier(16)->Range(16, 1 << 16);
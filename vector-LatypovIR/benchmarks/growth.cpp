@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../vector.h"
+
+// n push_backs into an empty vector with each growth policy, against
+// std::vector. Counters: reallocs, the times the buffer was allocated anew;
+// in_place, the growths that kept it; overhead, the unused part of the final
+// capacity relative to the size.
+namespace {
+template <typename Growth>
+using int_vector = vector<int, default_allocator<int>, Growth>;
+
+template <typename Growth>
+using string_vector =
+    vector<std::string, default_allocator<std::string>, Growth>;
+
+template <typename T>
+T make();
+
+template <>
+int make<int>() {
+  return 42;
+}
+
+template <>
+std::string make<std::string>() {
+  return "a string longer than the small buffer";
+}
+
+// range(0): n
+template <typename Vector>
+void BM_push_back(benchmark::State& state) {
+  size_t n = static_cast<size_t>(state.range(0));
+  auto value = make<typename Vector::value_type>();
+  size_t reallocs = 0;
+  size_t in_place = 0;
+  size_t capacity = 0;
+  for (auto _ : state) {
+    Vector a;
+    reallocs = 0;
+    in_place = 0;
+    auto* data = a.data();
+    capacity = a.capacity();
+    for (size_t i = 0; i != n; ++i) {
+      a.push_back(value);
+      if (a.capacity() != capacity) {
+        ++(a.data() == data ? in_place : reallocs);
+        data = a.data();
+        capacity = a.capacity();
+      }
+    }
+    benchmark::DoNotOptimize(a.data());
+  }
+  state.counters["reallocs"] = static_cast<double>(reallocs);
+  state.counters["in_place"] = static_cast<double>(in_place);
+  state.counters["overhead"] = static_cast<double>(capacity - n) / n;
+}
+
+void sizes(benchmark::internal::Benchmark* b) {
+  b->Arg(1000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_push_back, int_vector<double_growth>)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_push_back, int_vector<half_growth>)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_push_back, int_vector<page_growth>)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_push_back, int_vector<size_class_growth>)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_push_back, std::vector<int>)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_push_back, string_vector<double_growth>)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_push_back, string_vector<half_growth>)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_push_back, string_vector<page_growth>)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_push_back, string_vector<size_class_growth>)
+    ->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_push_back, std::vector<std::string>)->Apply(sizes);
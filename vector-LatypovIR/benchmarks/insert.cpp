@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "../vector.h"
+
+// Insertion of k elements into the front or the middle of a vector of 10^6
+// elements, and erasure of as many, against std::vector.
+namespace {
+size_t const SIZE = 1000000;
+
+template <typename T>
+T make(size_t i);
+
+template <>
+int make<int>(size_t i) {
+  return static_cast<int>(i);
+}
+
+template <>
+std::string make<std::string>(size_t i) {
+  return std::to_string(i);
+}
+
+template <typename Vector>
+using value_t = typename std::decay<decltype(*Vector().data())>::type;
+
+template <typename Vector>
+Vector filled(size_t n) {
+  using T = value_t<Vector>;
+  Vector result;
+  for (size_t i = 0; i != n; ++i) {
+    result.push_back(make<T>(i));
+  }
+  return result;
+}
+
+// range(0): 0 to insert at the front, 1 in the middle; range(1): k
+template <typename Vector>
+void BM_insert_range(benchmark::State& state) {
+  Vector a = filled<Vector>(SIZE);
+  auto range =
+      filled<std::vector<value_t<Vector>>>(static_cast<size_t>(state.range(1)));
+  size_t index = state.range(0) == 0 ? 0 : SIZE / 2;
+  for (auto _ : state) {
+    a.insert(a.begin() + index, range.begin(), range.end());
+    state.PauseTiming();
+    a.erase(a.begin() + index, a.begin() + index + range.size());
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+template <typename Vector>
+void BM_erase_range(benchmark::State& state) {
+  Vector a = filled<Vector>(SIZE);
+  auto range =
+      filled<std::vector<value_t<Vector>>>(static_cast<size_t>(state.range(1)));
+  size_t index = state.range(0) == 0 ? 0 : SIZE / 2;
+  for (auto _ : state) {
+    state.PauseTiming();
+    a.insert(a.begin() + index, range.begin(), range.end());
+    state.ResumeTiming();
+    a.erase(a.begin() + index, a.begin() + index + range.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+void positions(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"middle", "k"});
+  for (int middle : {0, 1}) {
+    for (int k : {1, 1000}) {
+      b->Args({middle, k});
+    }
+  }
+  b->Unit(benchmark::kMicrosecond);
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_insert_range, vector<int>)->Apply(positions);
+BENCHMARK_TEMPLATE(BM_insert_range, std::vector<int>)->Apply(positions);
+BENCHMARK_TEMPLATE(BM_insert_range, vector<std::string>)->Apply(positions);
+BENCHMARK_TEMPLATE(BM_insert_range, std::vector<std::string>)->Apply(positions);
+BENCHMARK_TEMPLATE(BM_erase_range, vector<int>)->Apply(positions);
+BENCHMARK_TEMPLATE(BM_erase_range, std::vector<int>)->Apply(positions);
+BENCHMARK_TEMPLATE(BM_erase_range, vector<std::string>)->Apply(positions);
+BENCHMARK_TEMPLATE(BM_erase_range, std::vector<std::string>)->Apply(positions);
@@ -0,0 +1,62 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+
+// Growth policies of vector: next(capacity, required, size) is the capacity
+// to grow to from capacity when required elements of size bytes must fit; it
+// is at least required.
+
+// doubles the capacity, starting from one element
+struct double_growth {
+  static size_t next(size_t capacity, size_t required, size_t) noexcept {
+    return std::max(required, capacity == 0 ? 1 : capacity * 2);
+  }
+};
+
+// grows by half, which wastes at most a third of the buffer and lets a freed
+// buffer be reused by a later growth
+struct half_growth {
+  static size_t next(size_t capacity, size_t required, size_t) noexcept {
+    return std::max(required, capacity + capacity / 2);
+  }
+};
+
+// doubles below a page, then grows by half to whole pages: large buffers are
+// mapped by the page, so the rounding is free
+struct page_growth {
+  static constexpr size_t PAGE = 4096;
+
+  static size_t next(size_t capacity, size_t required, size_t size) noexcept {
+    size_t bytes = required * size;
+    if (bytes < PAGE) {
+      return double_growth::next(capacity, required, size);
+    }
+    bytes = std::max(bytes, (capacity + capacity / 2) * size);
+    return (bytes + PAGE - 1) / PAGE * PAGE / size;
+  }
+};
+
+// grows by half to the end of a jemalloc size class, so the buffer has no
+// slack in a size-class allocator
+struct size_class_growth {
+  // 8, then multiples of 16 up to 128, then four classes per doubling
+  static size_t size_class(size_t bytes) noexcept {
+    if (bytes <= 8) {
+      return 8;
+    }
+    if (bytes <= 128) {
+      return (bytes + 15) & ~size_t(15);
+    }
+    size_t lg = 0;
+    while ((size_t(2) << lg) < bytes) {
+      ++lg;
+    }
+    size_t delta = size_t(1) << (lg - 2);
+    return (bytes + delta - 1) & ~(delta - 1);
+  }
+
+  static size_t next(size_t capacity, size_t required, size_t size) noexcept {
+    size_t bytes = std::max(required, capacity + capacity / 2) * size;
+    return size_class(bytes) / size;
+  }
+};
@@ -1,7 +1,17 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "gtest/gtest.h"
 
+#include "allocators.h"
 #include "vector.h"
 
 template struct vector<int>;
@@ -141,6 +151,137 @@ TEST(correctness, push_back_from_self) {
   element<size_t>::expect_no_instances();
 }
 
+// Counts how elements travel between buffers; the move constructor is noexcept
+// only if NoexceptMove.
+template <bool NoexceptMove>
+struct traveller {
+  static size_t copies;
+  static size_t moves;
+
+  explicit traveller(size_t val) : val(val) {}
+
+  traveller(traveller const& rhs) : val(rhs.val) {
+    ++copies;
+  }
+
+  traveller(traveller&& rhs) noexcept(NoexceptMove) : val(rhs.val) {
+    ++moves;
+  }
+
+  size_t val;
+};
+
+template <bool NoexceptMove>
+size_t traveller<NoexceptMove>::copies = 0;
+
+template <bool NoexceptMove>
+size_t traveller<NoexceptMove>::moves = 0;
+
+TEST(correctness, push_back_rvalue) {
+  size_t const N = 500;
+  vector<std::string> a;
+  for (size_t i = 0; i != N; ++i) {
+    std::string s(100, static_cast<char>('a' + i % 26));
+    char const* buffer = s.data();
+    a.push_back(std::move(s));
+    EXPECT_EQ(buffer, a.back().data());
+  }
+  for (size_t i = 0; i != N; ++i)
+    EXPECT_EQ(std::string(100, static_cast<char>('a' + i % 26)), a[i]);
+}
+
+TEST(correctness, emplace_back) {
+  size_t const N = 500;
+  vector<std::pair<size_t, std::string>> a;
+  for (size_t i = 0; i != N; ++i) {
+    auto& p = a.emplace_back(i, "xxx");
+    EXPECT_EQ(&a.back(), &p);
+  }
+  for (size_t i = 0; i != N; ++i) {
+    EXPECT_EQ(i, a[i].first);
+    EXPECT_EQ("xxx", a[i].second);
+  }
+}
+
+TEST(correctness, emplace_back_from_self) {
+  size_t const N = 500;
+  {
+    vector<element<size_t>> a;
+    a.emplace_back(42);
+    for (size_t i = 0; i != N; ++i)
+      a.emplace_back(a[0]);
+
+    for (size_t i = 0; i != a.size(); ++i)
+      EXPECT_EQ(42, a[i]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, growth_moves) {
+  using el_t = traveller<true>;
+  size_t const N = 5000;
+  vector<el_t> a;
+  el_t::copies = 0;
+  for (size_t i = 0; i != N; ++i)
+    a.emplace_back(i);
+  EXPECT_EQ(0, el_t::copies);
+  EXPECT_LT(0, el_t::moves);
+  a.shrink_to_fit();
+  EXPECT_EQ(0, el_t::copies);
+  for (size_t i = 0; i != N; ++i)
+    EXPECT_EQ(i, a[i].val);
+}
+
+TEST(correctness, growth_copies_throwing_move) {
+  using el_t = traveller<false>;
+  size_t const N = 5000;
+  vector<el_t> a;
+  el_t::moves = 0;
+  for (size_t i = 0; i != N; ++i)
+    a.emplace_back(i);
+  EXPECT_EQ(0, el_t::moves);
+  EXPECT_LT(0, el_t::copies);
+}
+
+TEST(correctness, move_ctor) {
+  size_t const N = 500;
+  {
+    vector<element<size_t>> a;
+    for (size_t i = 0; i != N; ++i)
+      a.push_back(i);
+    element<size_t>* old_data = a.data();
+
+    vector<element<size_t>> b = std::move(a);
+    EXPECT_EQ(old_data, b.data());
+    EXPECT_EQ(N, b.size());
+    EXPECT_TRUE(a.empty());
+    for (size_t i = 0; i != N; ++i)
+      EXPECT_EQ(i, b[i]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, move_assignment) {
+  size_t const N = 500;
+  {
+    vector<element<size_t>> a;
+    for (size_t i = 0; i != N; ++i)
+      a.push_back(2 * i + 1);
+    element<size_t>* old_data = a.data();
+
+    vector<element<size_t>> b;
+    b.push_back(42);
+
+    b = std::move(a);
+    EXPECT_EQ(old_data, b.data());
+    EXPECT_EQ(N, b.size());
+    EXPECT_TRUE(a.empty());
+    for (size_t i = 0; i != N; ++i)
+      EXPECT_EQ(2 * i + 1, b[i]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
 TEST(correctness, subscription) {
   size_t const N = 500;
   vector<size_t> a;
@@ -343,6 +484,131 @@ TEST(correctness, insert_end) {
   element<size_t>::expect_no_instances();
 }
 
+template <typename Insert>
+void check_range_insert(Insert insert) {
+  size_t const N = 100, K = 30;
+  for (size_t reserved : {N, N + K}) {
+    for (size_t index : {size_t(0), size_t(1), K / 2, N - K, N - 1, N}) {
+      {
+        vector<element<size_t>> a;
+        std::vector<size_t> expected;
+        a.reserve(reserved);
+        for (size_t i = 0; i != N; ++i) {
+          a.push_back(i);
+          expected.push_back(i);
+        }
+        std::vector<size_t> range;
+        for (size_t i = 0; i != K; ++i)
+          range.push_back(1000 + i);
+
+        auto it = insert(a, a.begin() + index, range);
+        expected.insert(expected.begin() + index, range.begin(), range.end());
+        EXPECT_EQ(a.begin() + index, it);
+        ASSERT_EQ(expected.size(), a.size());
+        for (size_t i = 0; i != expected.size(); ++i)
+          EXPECT_EQ(expected[i], a[i]);
+      }
+      element<size_t>::expect_no_instances();
+    }
+  }
+}
+
+TEST(correctness, insert_forward_range) {
+  check_range_insert([](vector<element<size_t>>& a,
+                        vector<element<size_t>>::iterator pos,
+                        std::vector<size_t> const& range) {
+    return a.insert(pos, range.begin(), range.end());
+  });
+}
+
+TEST(correctness, insert_input_range) {
+  check_range_insert([](vector<element<size_t>>& a,
+                        vector<element<size_t>>::iterator pos,
+                        std::vector<size_t> const& range) {
+    std::stringstream stream;
+    for (size_t x : range)
+      stream << x << ' ';
+    return a.insert(pos, std::istream_iterator<size_t>(stream),
+                    std::istream_iterator<size_t>());
+  });
+}
+
+TEST(correctness, insert_copies) {
+  {
+    vector<element<size_t>> a;
+    a.reserve(100);
+    for (size_t i = 0; i != 10; ++i)
+      a.push_back(i);
+    a.insert(a.begin() + 2, 3, a[8]);
+    a.insert(a.begin() + 1, 20, a[0]);
+    a.insert(a.end() - 1, 80, a.back());
+    a.insert(a.begin(), 0, a[3]);
+
+    std::vector<size_t> expected = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    expected.insert(expected.begin() + 2, 3, expected[8]);
+    expected.insert(expected.begin() + 1, 20, expected[0]);
+    expected.insert(expected.end() - 1, 80, expected.back());
+    ASSERT_EQ(expected.size(), a.size());
+    for (size_t i = 0; i != expected.size(); ++i)
+      EXPECT_EQ(expected[i], a[i]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, emplace_from_self) {
+  size_t const N = 500;
+  {
+    vector<element<size_t>> a;
+    std::vector<size_t> expected;
+    for (size_t i = 0; i != N; ++i) {
+      size_t index = i * 7 % (a.size() + 1);
+      if (a.empty()) {
+        a.emplace(a.begin(), i);
+        expected.push_back(i);
+      } else {
+        size_t source = i * 3 % a.size();
+        a.emplace(a.begin() + index, a[source]);
+        expected.insert(expected.begin() + index, expected[source]);
+      }
+    }
+    for (size_t i = 0; i != N; ++i)
+      EXPECT_EQ(expected[i], a[i]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, insert_range_throw) {
+  {
+    vector<element<size_t>> a;
+    for (size_t i = 0; i != 10; ++i)
+      a.push_back(i);
+    std::vector<element<size_t>> range(10, element<size_t>(42));
+
+    element<size_t>::set_throw_countdown(5);
+    EXPECT_THROW(a.insert(a.begin() + 3, range.begin(), range.end()),
+                 std::runtime_error);
+    EXPECT_EQ(10, a.size());
+    for (size_t i = 0; i != a.size(); ++i)
+      EXPECT_EQ(i, a[i]);
+
+    a.reserve(100);
+    element<size_t>::set_throw_countdown(5);
+    EXPECT_THROW(a.insert(a.begin() + 3, range.begin(), range.end()),
+                 std::runtime_error);
+    EXPECT_GE(a.capacity(), a.size());
+    element<size_t>::set_throw_countdown(0);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, erase_empty_range) {
+  vector<int> a;
+  for (int i = 0; i != 10; ++i)
+    a.push_back(i);
+  EXPECT_EQ(a.begin() + 4, a.erase(a.begin() + 4, a.begin() + 4));
+  EXPECT_EQ(10, a.size());
+}
+
 TEST(performance, insert) {
   const size_t N = 10000;
   vector<vector<int>> a;
@@ -555,3 +821,430 @@ TEST(correctness, ctor_alloc) {
   auto b = a;
   EXPECT_EQ(1, b.capacity());
 }
+
+// Owns a heap value through a pointer, so moving it is copying the pointer.
+struct relocatable_box {
+  static size_t instances;
+
+  explicit relocatable_box(size_t val) : ptr(new size_t(val)) {
+    ++instances;
+  }
+
+  relocatable_box(relocatable_box const& rhs) : ptr(new size_t(*rhs.ptr)) {
+    ++instances;
+  }
+
+  relocatable_box& operator=(relocatable_box const& rhs) {
+    *ptr = *rhs.ptr;
+    return *this;
+  }
+
+  ~relocatable_box() {
+    delete ptr;
+    --instances;
+  }
+
+  size_t* ptr;
+};
+
+size_t relocatable_box::instances = 0;
+
+template <>
+struct vector_traits::is_trivially_relocatable<relocatable_box> : std::true_type {};
+
+TEST(correctness, trivially_relocatable_trait) {
+  EXPECT_TRUE(vector_traits::is_trivially_relocatable<int>::value);
+  EXPECT_TRUE(vector_traits::is_trivially_relocatable<double*>::value);
+  EXPECT_TRUE(vector_traits::is_trivially_relocatable<relocatable_box>::value);
+  EXPECT_FALSE(vector_traits::is_trivially_relocatable<std::string>::value);
+  EXPECT_FALSE(vector_traits::is_trivially_relocatable<element<size_t>>::value);
+}
+
+template <typename T, typename Get>
+void check_insert_erase(Get get) {
+  size_t const N = 500;
+  vector<T> a;
+  std::vector<size_t> expected;
+  for (size_t i = 0; i != N; ++i) {
+    size_t index = i * 7 % (a.size() + 1);
+    a.insert(a.begin() + index, T(i));
+    expected.insert(expected.begin() + index, i);
+  }
+  a.insert(a.begin() + 3, a[N / 2]);
+  expected.insert(expected.begin() + 3, expected[N / 2]);
+  std::vector<T> range;
+  std::vector<size_t> values;
+  for (size_t i = 0; i != 40; ++i) {
+    range.push_back(T(1000 + i));
+    values.push_back(1000 + i);
+  }
+  a.insert(a.begin() + 7, range.begin(), range.end());
+  expected.insert(expected.begin() + 7, values.begin(), values.end());
+  a.insert(a.begin() + 1, 5, a[2]);
+  expected.insert(expected.begin() + 1, 5, expected[2]);
+  a.reserve(a.size() + 100);
+  a.insert(a.begin() + 11, range.begin(), range.end());
+  expected.insert(expected.begin() + 11, values.begin(), values.end());
+  a.erase(a.begin() + 10, a.begin() + 110);
+  expected.erase(expected.begin() + 10, expected.begin() + 110);
+  a.erase(a.begin());
+  expected.erase(expected.begin());
+  a.erase(a.end() - 5, a.end());
+  expected.erase(expected.end() - 5, expected.end());
+  a.shrink_to_fit();
+
+  ASSERT_EQ(expected.size(), a.size());
+  for (size_t i = 0; i != expected.size(); ++i)
+    EXPECT_EQ(expected[i], get(a[i]));
+}
+
+TEST(correctness, trivially_relocatable_insert_erase) {
+  check_insert_erase<size_t>([](size_t x) { return x; });
+}
+
+TEST(correctness, declared_relocatable_insert_erase) {
+  check_insert_erase<relocatable_box>(
+      [](relocatable_box const& x) { return *x.ptr; });
+  EXPECT_EQ(0, relocatable_box::instances);
+
+  {
+    size_t const N = 5000;
+    vector<relocatable_box> a;
+    std::vector<size_t> expected;
+    a.emplace_back(1);
+    expected.push_back(1);
+    for (size_t i = 1; i != N; ++i) {
+      if (i % 2 == 0) {
+        a.emplace_back(i);
+        expected.push_back(i);
+      } else {
+        a.emplace_back(a[i / 2]);
+        expected.push_back(expected[i / 2]);
+      }
+    }
+    vector<relocatable_box> b = a;
+    a.clear();
+    EXPECT_EQ(N, relocatable_box::instances);
+    for (size_t i = 0; i != N; ++i)
+      EXPECT_EQ(expected[i], *b[i].ptr);
+  }
+  EXPECT_EQ(0, relocatable_box::instances);
+}
+
+// Counts the bytes each allocator (told apart by id) has handed out, so that
+// a buffer freed through another allocator shows up.
+template <typename T, bool Propagate>
+struct tagged_allocator {
+  using value_type = T;
+  using propagate_on_container_copy_assignment =
+      std::integral_constant<bool, Propagate>;
+  using propagate_on_container_move_assignment =
+      std::integral_constant<bool, Propagate>;
+  using propagate_on_container_swap = std::integral_constant<bool, Propagate>;
+
+  explicit tagged_allocator(int id) : id(id) {}
+
+  template <typename U>
+  tagged_allocator(tagged_allocator<U, Propagate> const& other)
+      : id(other.id) {}
+
+  static std::unordered_map<int, size_t>& live() {
+    static std::unordered_map<int, size_t> live;
+    return live;
+  }
+
+  T* allocate(size_t n) {
+    live()[id] += n;
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* p, size_t n) {
+    EXPECT_GE(live()[id], n);
+    live()[id] -= n;
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  friend bool operator==(tagged_allocator const& a, tagged_allocator const& b) {
+    return a.id == b.id;
+  }
+
+  friend bool operator!=(tagged_allocator const& a, tagged_allocator const& b) {
+    return a.id != b.id;
+  }
+
+  int id;
+};
+
+template <bool Propagate>
+void check_propagation() {
+  using alloc_t = tagged_allocator<element<size_t>, Propagate>;
+  using vec_t = vector<element<size_t>, alloc_t>;
+  size_t const N = 100;
+  {
+    vec_t a{alloc_t(1)};
+    vec_t b{alloc_t(2)};
+    for (size_t i = 0; i != N; ++i) {
+      a.push_back(i);
+      b.push_back(2 * i);
+    }
+
+    vec_t c = a;
+    EXPECT_EQ(1, c.get_allocator().id);
+
+    c = b;
+    EXPECT_EQ(Propagate ? 2 : 1, c.get_allocator().id);
+    EXPECT_EQ(2 * (N - 1), c.back());
+
+    element<size_t>* b_data = b.data();
+    a = std::move(b);
+    EXPECT_EQ(Propagate ? 2 : 1, a.get_allocator().id);
+    EXPECT_EQ(Propagate, a.data() == b_data);
+    EXPECT_EQ(N, a.size());
+    for (size_t i = 0; i != N; ++i)
+      EXPECT_EQ(2 * i, a[i]);
+
+    vec_t d(std::move(a));
+    EXPECT_EQ(Propagate ? 2 : 1, d.get_allocator().id);
+
+    if (Propagate) {
+      vec_t e{alloc_t(3)};
+      e.push_back(7);
+      d.swap(e);
+      EXPECT_EQ(3, d.get_allocator().id);
+      EXPECT_EQ(2, e.get_allocator().id);
+      EXPECT_EQ(7, d[0]);
+    }
+  }
+  for (auto const& p : alloc_t::live())
+    EXPECT_EQ(0, p.second);
+  element<size_t>::expect_no_instances();
+}
+
+TEST(allocator, propagating) {
+  check_propagation<true>();
+}
+
+TEST(allocator, not_propagating) {
+  check_propagation<false>();
+}
+
+TEST(allocator, arena) {
+  using alloc_t = arena_allocator<element<size_t>>;
+  size_t const N = 5000;
+  arena memory;
+  {
+    vector<element<size_t>, alloc_t> a{alloc_t(memory)};
+    for (size_t i = 0; i != N; ++i)
+      a.push_back(i);
+    a.insert(a.begin() + 10, 100, a[5]);
+    a.erase(a.begin() + 10, a.begin() + 110);
+
+    vector<element<size_t>, alloc_t> b = a;
+    EXPECT_TRUE(b.get_allocator() == a.get_allocator());
+    for (size_t i = 0; i != N; ++i)
+      EXPECT_EQ(i, b[i]);
+  }
+  element<size_t>::expect_no_instances();
+  EXPECT_LT(0, memory.reserved());
+
+  size_t reserved = memory.reserved();
+  memory.reset();
+  EXPECT_GE(reserved, memory.reserved());
+  EXPECT_LT(0, memory.reserved());
+  memory.release();
+  EXPECT_EQ(0, memory.reserved());
+}
+
+TEST(allocator, arena_alignment) {
+  // the chunk size is not a multiple of the larger alignments
+  arena memory(1000);
+  char* bytes = static_cast<char*>(memory.allocate(995, 1));
+  std::fill(bytes, bytes + 995, 'x');
+  char* aligned = static_cast<char*>(memory.allocate(16, 16));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(aligned) % 16);
+  std::fill(aligned, aligned + 16, 'y');
+
+  std::vector<std::pair<char*, size_t>> blocks;
+  for (size_t i = 0; i != 300; ++i) {
+    size_t alignment = size_t(1) << (i % 5);
+    size_t size = 1 + i * 7 % 23;
+    char* p = static_cast<char*>(memory.allocate(size, alignment));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) % alignment);
+    std::fill(p, p + size, static_cast<char>(i));
+    blocks.emplace_back(p, size);
+  }
+  for (size_t i = 0; i != blocks.size(); ++i)
+    for (size_t j = 0; j != blocks[i].second; ++j)
+      EXPECT_EQ(static_cast<char>(i), blocks[i].first[j]);
+  EXPECT_EQ('x', bytes[994]);
+  EXPECT_EQ('y', aligned[15]);
+}
+
+TEST(allocator, arena_nested) {
+  using inner_t = vector<size_t, arena_allocator<size_t>>;
+  arena memory(64);
+  vector<inner_t, arena_allocator<inner_t>> a{arena_allocator<inner_t>(memory)};
+  for (size_t i = 0; i != 100; ++i) {
+    a.emplace_back(arena_allocator<size_t>(memory));
+    for (size_t j = 0; j != i; ++j)
+      a.back().push_back(j);
+  }
+  a.erase(a.begin(), a.begin() + 50);
+  for (size_t i = 0; i != a.size(); ++i) {
+    ASSERT_EQ(i + 50, a[i].size());
+    EXPECT_EQ(i + 49, a[i].back());
+  }
+}
+
+TEST(allocator, pool) {
+  using alloc_t = pool_allocator<element<size_t>>;
+  size_t const N = 5000;
+  pool memory;
+  {
+    vector<element<size_t>, alloc_t> a{alloc_t(memory)};
+    for (size_t i = 0; i != N; ++i)
+      a.push_back(i);
+    vector<element<size_t>, alloc_t> b = a;
+    b.shrink_to_fit();
+    a.clear();
+    a.shrink_to_fit();
+    EXPECT_LE(N * sizeof(element<size_t>), memory.in_use());
+
+    for (size_t round = 0; round != 10; ++round) {
+      vector<element<size_t>, alloc_t> c{alloc_t(memory)};
+      for (size_t i = 0; i != 100; ++i)
+        c.push_back(i);
+    }
+    for (size_t i = 0; i != N; ++i)
+      EXPECT_EQ(i, b[i]);
+  }
+  EXPECT_EQ(0, memory.in_use());
+  element<size_t>::expect_no_instances();
+}
+
+TEST(growth, policies) {
+  EXPECT_EQ(1, double_growth::next(0, 1, 4));
+  EXPECT_EQ(20, double_growth::next(10, 11, 4));
+  EXPECT_EQ(30, double_growth::next(10, 30, 4));
+
+  EXPECT_EQ(1, half_growth::next(0, 1, 4));
+  EXPECT_EQ(2, half_growth::next(1, 2, 4));
+  EXPECT_EQ(15, half_growth::next(10, 11, 4));
+
+  EXPECT_EQ(200, page_growth::next(100, 101, 4));
+  EXPECT_EQ(2048, page_growth::next(1024, 1025, 4));
+  EXPECT_EQ(3072, page_growth::next(2048, 2049, 4));
+  EXPECT_EQ(2048, page_growth::next(1000, 1001, 6));
+
+  EXPECT_EQ(8, size_class_growth::size_class(1));
+  EXPECT_EQ(48, size_class_growth::size_class(40));
+  EXPECT_EQ(160, size_class_growth::size_class(129));
+  EXPECT_EQ(256, size_class_growth::size_class(256));
+  EXPECT_EQ(320, size_class_growth::size_class(257));
+  EXPECT_EQ(1280, size_class_growth::size_class(1100));
+  EXPECT_EQ(32, size_class_growth::next(20, 21, 8));
+}
+
+// element<size_t> has no allocator hook and no realloc, so capacities follow
+// the policy exactly
+template <typename Growth>
+void check_growth() {
+  size_t const N = 5000;
+  {
+    vector<element<size_t>, default_allocator<element<size_t>>, Growth> a;
+    size_t capacity = 0;
+    for (size_t i = 0; i != N; ++i) {
+      if (a.size() == capacity) {
+        capacity = Growth::next(capacity, capacity + 1, sizeof(element<size_t>));
+      }
+      a.push_back(i);
+      ASSERT_EQ(capacity, a.capacity());
+    }
+    a.insert(a.begin() + 10, 1000, a[0]);
+    EXPECT_LE(N + 1000, a.capacity());
+    a.erase(a.begin() + 10, a.begin() + 1010);
+    for (size_t i = 0; i != N; ++i)
+      EXPECT_EQ(i, a[i]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(growth, double_growth) {
+  check_growth<double_growth>();
+}
+
+TEST(growth, half_growth) {
+  check_growth<half_growth>();
+}
+
+TEST(growth, page_growth) {
+  check_growth<page_growth>();
+}
+
+TEST(growth, size_class_growth) {
+  check_growth<size_class_growth>();
+}
+
+TEST(growth, malloc_slack) {
+  vector<int, default_allocator<int>, half_growth> a;
+  for (int i = 0; i != 100000; ++i) {
+    a.push_back(i);
+    ASSERT_LE(a.size(), a.capacity());
+  }
+  a.reserve(200000);
+  EXPECT_LE(200000, a.capacity());
+  for (int i = 0; i != 100000; ++i)
+    EXPECT_EQ(i, a[i]);
+}
+
+TEST(growth, arena_in_place) {
+  using alloc_t = arena_allocator<int>;
+  arena memory(1 << 16);
+  vector<int, alloc_t> a{alloc_t(memory)};
+  a.push_back(0);
+  int* data = a.data();
+  for (int i = 1; i != 10000; ++i)
+    a.push_back(i);
+  EXPECT_EQ(data, a.data());
+  EXPECT_EQ(1 << 16, memory.reserved());
+
+  a.erase(a.begin() + 5000, a.end());
+  a.shrink_to_fit();
+  EXPECT_EQ(data, a.data());
+  EXPECT_EQ(5000, a.capacity());
+
+  // a block that is not the last one moves
+  vector<int, alloc_t> b{alloc_t(memory)};
+  b.push_back(0);
+  a.push_back(5000);
+  EXPECT_NE(data, a.data());
+  for (int i = 0; i != 5001; ++i)
+    EXPECT_EQ(i, a[i]);
+}
+
+TEST(growth, pool_in_place) {
+  using alloc_t = pool_allocator<std::array<char, 24>>;
+  pool memory;
+  {
+    vector<std::array<char, 24>, alloc_t> a{alloc_t(memory)};
+    // 72 bytes in a block of 128
+    a.reserve(3);
+    EXPECT_EQ(3, a.capacity());
+    std::array<char, 24> x{};
+    for (char i = 0; i != 3; ++i) {
+      x[0] = i;
+      a.push_back(x);
+    }
+    auto* data = a.data();
+    x[0] = 3;
+    a.push_back(x);
+    EXPECT_EQ(data, a.data());
+    EXPECT_EQ(5, a.capacity());
+    a.push_back(x);
+    a.push_back(x);
+    EXPECT_NE(data, a.data());
+    for (char i = 0; i != 4; ++i)
+      EXPECT_EQ(i, a[i][0]);
+  }
+  EXPECT_EQ(0, memory.in_use());
+}
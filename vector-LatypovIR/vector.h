@@ -1,43 +1,163 @@
 #pragma once
+#include <algorithm>
 #include <cstddef>
-
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "growth.h"
+
+// A type is trivially relocatable if moving an object to a new address and
+// destroying the old one is the same as copying its bytes. This is so for
+// trivially copyable types and can be declared for others by specialization,
+// e.g. for a type that owns a heap buffer through a pointer:
+//   template <>
+//   struct vector_traits::is_trivially_relocatable<my_type>
+//       : std::true_type {};
+// The trait has its own namespace, so that it does not clash with the one of
+// socow_vector.
+namespace vector_traits {
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+} // namespace vector_traits
+
+// An allocator may grow or shrink a block in place with
+//   size_t resize_in_place(T* p, size_t n, size_t wanted) noexcept,
+// which makes the block of n elements at p hold at least wanted elements
+// without moving it and returns how many it holds then, or 0 if it cannot.
+// The block is then deallocated with that count.
+template <typename Allocator, typename T, typename = void>
+struct has_resize_in_place : std::false_type {};
+
+template <typename Allocator, typename T>
+struct has_resize_in_place<
+    Allocator, T,
+    std::void_t<decltype(std::declval<Allocator&>().resize_in_place(
+        std::declval<T*>(), size_t(), size_t()))>> : std::true_type {};
+
+// std::allocator under a name of the global namespace: were std::allocator a
+// template argument of vector, argument-dependent lookup would look into std
+// for every call taking a vector.
 template <typename T>
+struct default_allocator {
+  using value_type = T;
+
+  default_allocator() noexcept = default;
+
+  template <typename U>
+  default_allocator(default_allocator<U> const&) noexcept {}
+
+  T* allocate(size_t n) {
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* p, size_t n) noexcept {
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  friend bool operator==(default_allocator const&,
+                         default_allocator const&) noexcept {
+    return true;
+  }
+
+  friend bool operator!=(default_allocator const&,
+                         default_allocator const&) noexcept {
+    return false;
+  }
+};
+
+// The buffer comes from Allocator, which is propagated on copy, move and
+// swap as std::allocator_traits says, and grows as Growth says (growth.h).
+template <typename T, typename Allocator = default_allocator<T>,
+          typename Growth = double_growth>
 struct vector {
+  using value_type = T;
+  using allocator_type = Allocator;
   using iterator = T*;
   using const_iterator = T const*;
 
-  vector() : size_(0), capacity_(0), data_(nullptr){};
+  vector() noexcept(noexcept(Allocator()))
+      : storage_(Allocator()), size_(0), capacity_(0){};
+
+  explicit vector(Allocator const& alloc) noexcept
+      : storage_(alloc), size_(0), capacity_(0){};
+
+  vector(vector const& other)
+      : vector(other, traits::select_on_container_copy_construction(
+                          other.allocator())){};
 
-  vector(vector const& other) : vector() {
+  vector(vector const& other, Allocator const& alloc) : vector(alloc) {
     ensure_capacity(other.size_);
     while (size_ < other.size_) {
       save_object(other[size_]);
     }
   };
 
+  vector(vector&& other) noexcept
+      : storage_(std::move(other.allocator())), size_(0), capacity_(0) {
+    swap_storage(other);
+  };
+
   vector& operator=(vector const& other) {
-    vector(other).swap(*this);
+    if (this != &other) {
+      vector(other, traits::propagate_on_container_copy_assignment::value
+                        ? other.allocator()
+                        : allocator())
+          .exchange(*this);
+    }
+    return *this;
+  };
+
+  // takes the buffer of other unless the allocators differ and do not
+  // propagate, then moves the elements one by one
+  vector& operator=(vector&& other) noexcept(
+      traits::propagate_on_container_move_assignment::value ||
+      traits::is_always_equal::value) {
+    if (traits::propagate_on_container_move_assignment::value ||
+        allocator() == other.allocator()) {
+      vector(std::move(other)).exchange(*this);
+    } else if (this != &other) {
+      vector moved(allocator());
+      moved.ensure_capacity(other.size_);
+      for (T& obj : other) {
+        moved.save_object(std::move(obj));
+      }
+      moved.exchange(*this);
+    }
     return *this;
   };
 
   ~vector() {
-    erase_object(data_, size_);
+    destroy(storage_.data, size_);
+    deallocate(storage_.data, capacity_);
+  };
+
+  allocator_type get_allocator() const noexcept {
+    return allocator();
   };
 
   T& operator[](size_t i) {
-    return data_[i];
+    return storage_.data[i];
   };
 
   T const& operator[](size_t i) const {
-    return data_[i];
+    return storage_.data[i];
   };
 
   T* data() {
-    return data_;
+    return storage_.data;
   };
 
   T const* data() const {
-    return data_;
+    return storage_.data;
   };
 
   size_t size() const {
@@ -45,33 +165,58 @@ struct vector {
   };
 
   T& front() {
-    return data_[0];
+    return storage_.data[0];
   };
 
   T const& front() const {
-    return data_[0];
+    return storage_.data[0];
   };
 
   T& back() {
-    return data_[size_ - 1];
+    return storage_.data[size_ - 1];
   };
 
   T const& back() const {
-    return data_[size_ - 1];
+    return storage_.data[size_ - 1];
   };
 
   void push_back(T const& obj) {
-    if (size_ == capacity_) {
-      T tmp_obj = obj;
-      ensure_capacity(capacity_ == 0 ? 1 : capacity_ * 2);
-      save_object(tmp_obj);
-    } else {
-      save_object(obj);
-    }
+    emplace_back(obj);
+  };
+
+  void push_back(T&& obj) {
+    emplace_back(std::move(obj));
   };
 
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    if (size_ != capacity_ || try_expand_in_place(size_ + 1)) {
+      save_object(std::forward<Args>(args)...);
+      return back();
+    }
+    size_t new_capacity_ = next_capacity(size_ + 1);
+    if constexpr (uses_realloc) {
+      // args may refer to an element, so the new one is built aside while
+      // realloc moves the buffer, possibly in place
+      alignas(T) unsigned char obj[sizeof(T)];
+      new (obj) T(std::forward<Args>(args)...);
+      try {
+        ensure_capacity(new_capacity_);
+      } catch (...) {
+        reinterpret_cast<T*>(obj)->~T();
+        throw;
+      }
+      std::memcpy(static_cast<void*>(storage_.data + size_), obj, sizeof(T));
+      return storage_.data[size_++];
+    }
+    reallocate_with_gap(new_capacity_, size_, 1, [&](T* slot) {
+      construct(slot, std::forward<Args>(args)...);
+    });
+    return back();
+  }
+
   void pop_back() {
-    data_[--size_].~T();
+    traits::destroy(allocator(), storage_.data + --size_);
   };
 
   bool empty() const {
@@ -83,104 +228,450 @@ struct vector {
   };
 
   void reserve(size_t new_capacity_) {
-    if (new_capacity_ > capacity_) {
+    if (new_capacity_ > capacity_ &&
+        !try_expand_in_place(new_capacity_, new_capacity_)) {
       ensure_capacity(new_capacity_);
     }
   };
 
   void shrink_to_fit() {
-    if (size_ != capacity_) {
-      ensure_capacity(size_);
+    if (size_ == capacity_) {
+      return;
     }
+    if constexpr (has_resize_in_place<Allocator, T>::value) {
+      size_t held = 0;
+      if (size_ != 0) {
+        held = allocator().resize_in_place(storage_.data, capacity_, size_);
+      }
+      if (held != 0) {
+        capacity_ = held;
+        return;
+      }
+    }
+    ensure_capacity(size_);
   };
 
   void clear() {
-    while (size_ > 0) {
-      pop_back();
-    }
+    destroy(storage_.data, size_);
+    size_ = 0;
   };
 
-  void swap(vector& other) {
-    std::swap(other.size_, size_);
-    std::swap(other.capacity_, capacity_);
-    std::swap(other.data_, data_);
+  // the allocators must be equal unless they propagate on swap
+  void swap(vector& other) noexcept {
+    if constexpr (traits::propagate_on_container_swap::value) {
+      std::swap(allocator(), other.allocator());
+    }
+    swap_storage(other);
   };
 
   iterator begin() {
-    return data_;
+    return storage_.data;
   };
 
   iterator end() {
-    return data_ + size_;
+    return storage_.data + size_;
   };
 
   const_iterator begin() const {
-    return data_;
+    return storage_.data;
   };
 
   const_iterator end() const {
-    return data_ + size_;
+    return storage_.data + size_;
   };
 
   iterator insert(const_iterator pos, T const& obj) {
+    return emplace(pos, obj);
+  };
+
+  iterator insert(const_iterator pos, T&& obj) {
+    return emplace(pos, std::move(obj));
+  };
+
+  iterator insert(const_iterator pos, size_t n, T const& obj) {
     size_t index = pos - begin();
-    push_back(obj);
-    for (size_t i = size_ - 1; i != index; --i) {
-      std::swap(data_[i], data_[i - 1]);
+    // obj may be an element that the insertion moves
+    T copy(obj);
+    return insert_from(index, n, copies_source{copy});
+  };
+
+  // [first, last) must not be a range of this vector
+  template <typename InputIt, typename = typename std::iterator_traits<
+                                  InputIt>::iterator_category>
+  iterator insert(const_iterator pos, InputIt first, InputIt last) {
+    size_t index = pos - begin();
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+      size_t n = std::distance(first, last);
+      return insert_from(index, n, range_source<InputIt>{first});
+    } else {
+      // the length is unknown until the range is read
+      size_t old_size = size_;
+      for (; first != last; ++first) {
+        emplace_back(*first);
+      }
+      std::rotate(begin() + index, begin() + old_size, end());
+      return begin() + index;
+    }
+  }
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args) {
+    size_t index = pos - begin();
+    if (index == size_) {
+      emplace_back(std::forward<Args>(args)...);
+    } else if (size_ == capacity_ && !try_expand_in_place(size_ + 1)) {
+      reallocate_with_gap(next_capacity(size_ + 1), index, 1, [&](T* slot) {
+        construct(slot, std::forward<Args>(args)...);
+      });
+    } else {
+      // args may refer to an element that the insertion moves
+      T obj(std::forward<Args>(args)...);
+      insert_from(index, 1,
+                  range_source<std::move_iterator<T*>>{
+                      std::make_move_iterator(&obj)});
     }
     return begin() + index;
-  };
+  }
 
   iterator erase(const_iterator pos) {
     return erase(pos, pos + 1);
   };
 
   iterator erase(const_iterator first, const_iterator last) {
-    if (first >= last)
-      return nullptr;
-    size_t count = std::distance(first, last),
-           start = std::distance(begin(), (iterator)first);
-    for (size_t i = start; i + count != size_; i++) {
-      std::swap(data_[i], data_[i + count]);
+    size_t start = first - begin();
+    if (first >= last) {
+      return begin() + start;
     }
-    for (size_t i = 0; i < count; i++) {
-      pop_back();
+    size_t count = last - first;
+    T* removed = storage_.data + start;
+    if constexpr (vector_traits::is_trivially_relocatable<T>::value) {
+      destroy(removed, count);
+      std::memmove(static_cast<void*>(removed), removed + count,
+                   (size_ - start - count) * sizeof(T));
+    } else {
+      std::move(removed + count, end(), removed);
+      destroy(end() - count, count);
     }
-    return data_ + start;
+    size_ -= count;
+    return begin() + start;
   };
 
 private:
-  void ensure_capacity(size_t const new_capacity_) {
-    T* new_data_ = new_capacity_ == 0
-                     ? nullptr
-                     : static_cast<T*>(operator new(new_capacity_ * sizeof(T)));
+  using traits = std::allocator_traits<Allocator>;
+  static_assert(std::is_same<typename traits::pointer, T*>::value,
+                "the allocator must hand out plain pointers");
+
+  // with the default allocator, buffers of trivially relocatable elements
+  // come from malloc, so that growth can go through realloc
+  static constexpr bool uses_realloc =
+      (std::is_same<Allocator, default_allocator<T>>::value ||
+       std::is_same<Allocator, std::allocator<T>>::value) &&
+      vector_traits::is_trivially_relocatable<T>::value &&
+      alignof(T) <= alignof(std::max_align_t);
+
+  Allocator& allocator() noexcept {
+    return storage_;
+  }
+
+  Allocator const& allocator() const noexcept {
+    return storage_;
+  }
+
+  void swap_storage(vector& other) noexcept {
+    std::swap(other.size_, size_);
+    std::swap(other.capacity_, capacity_);
+    std::swap(other.storage_.data, storage_.data);
+  }
+
+  // swaps the allocators too, so each buffer stays with its allocator
+  void exchange(vector& other) noexcept {
+    std::swap(allocator(), other.allocator());
+    swap_storage(other);
+  }
+
+  // the new elements of an insertion, read in order
+  struct copies_source {
+    T const& obj;
+
+    T const& next() {
+      return obj;
+    }
+  };
+
+  template <typename It>
+  struct range_source {
+    It it;
+
+    decltype(auto) next() {
+      return *it++;
+    }
+  };
+
+  size_t next_capacity(size_t required) const {
+    return Growth::next(capacity_, required, sizeof(T));
+  }
+
+  bool try_expand_in_place(size_t required) {
+    return try_expand_in_place(required, next_capacity(required));
+  }
 
-    for (size_t i = 0; i != size_; ++i) {
+  // Makes room for required elements without moving the buffer: takes the
+  // slack malloc left at its end, or lets the allocator extend it to wanted
+  // elements, or at least to required ones.
+  bool try_expand_in_place(size_t required, size_t wanted) {
+    if (storage_.data == nullptr) {
+      return false;
+    }
+    size_t held = 0;
+    if constexpr (uses_realloc) {
+#if defined(__GLIBC__)
+      held = malloc_usable_size(storage_.data) / sizeof(T);
+#endif
+    } else if constexpr (has_resize_in_place<Allocator, T>::value) {
+      held = allocator().resize_in_place(storage_.data, capacity_, wanted);
+      if (held == 0 && wanted > required) {
+        held = allocator().resize_in_place(storage_.data, capacity_, required);
+      }
+    }
+    if (held < required) {
+      return false;
+    }
+    capacity_ = held;
+    return true;
+  }
+
+  void ensure_capacity(size_t const new_capacity_) {
+    if constexpr (uses_realloc) {
+      if (new_capacity_ == 0) {
+        std::free(storage_.data);
+        storage_.data = nullptr;
+      } else {
+        void* new_data_ = std::realloc(static_cast<void*>(storage_.data),
+                                       new_capacity_ * sizeof(T));
+        if (new_data_ == nullptr) {
+          throw std::bad_alloc();
+        }
+        storage_.data = static_cast<T*>(new_data_);
+      }
+    } else {
+      T* new_data_ = allocate(new_capacity_);
       try {
-        new (new_data_ + i) T(data_[i]);
+        relocate(storage_.data, size_, new_data_);
       } catch (...) {
-        erase_object(new_data_, i);
+        deallocate(new_data_, new_capacity_);
         throw;
       }
+      deallocate(storage_.data, capacity_);
+      storage_.data = new_data_;
     }
-    erase_object(data_, size_);
-    data_ = new_data_;
     capacity_ = new_capacity_;
   }
 
-  void save_object(T const& obj) {
-    new(data_ + size_) T(obj);
-    size_++;
+  // Moves the elements to a new buffer, leaving n slots at index for the
+  // new elements. fill constructs them before anything moves, as they may
+  // refer to the old ones, and destroys what it built if it throws. Strong
+  // guarantee.
+  template <typename Fill>
+  void reallocate_with_gap(size_t new_capacity_, size_t index, size_t n,
+                           Fill fill) {
+    // read before the calls below, which the compiler cannot see through, so
+    // that it knows index <= old_size < new_capacity_ and the tail is bounded
+    size_t const old_size = size_;
+    size_t const tail = index < old_size ? old_size - index : 0;
+    T* new_data_ = allocate(new_capacity_);
+    try {
+      fill(new_data_ + index);
+    } catch (...) {
+      deallocate(new_data_, new_capacity_);
+      throw;
+    }
+    size_t moved = 0;
+    try {
+      move_construct(storage_.data, index, new_data_);
+      moved = index;
+      move_construct(storage_.data + index, tail, new_data_ + index + n);
+    } catch (...) {
+      destroy(new_data_, moved);
+      destroy(new_data_ + index, n);
+      deallocate(new_data_, new_capacity_);
+      throw;
+    }
+    destroy_moved(storage_.data, old_size);
+    deallocate(storage_.data, capacity_);
+    storage_.data = new_data_;
+    size_ = old_size + n;
+    capacity_ = new_capacity_;
   }
 
-  void erase_object(T* arr, size_t cnt) {
-    while (cnt > 0) {
-      arr[--cnt].~T();
+  // Inserts n elements read from src at index, shifting the tail once. The
+  // elements of src must not be ones of this vector.
+  template <typename Source>
+  iterator insert_from(size_t index, size_t n, Source src) {
+    if (n == 0) {
+      return begin() + index;
+    }
+    if (size_ + n > capacity_ && !try_expand_in_place(size_ + n)) {
+      reallocate_with_gap(next_capacity(size_ + n), index, n,
+                          [&](T* gap) { construct_from(gap, n, src); });
+      return begin() + index;
+    }
+    T* gap = storage_.data + index;
+    size_t tail = size_ - index;
+    if constexpr (vector_traits::is_trivially_relocatable<T>::value) {
+      std::memmove(static_cast<void*>(gap + n), gap, tail * sizeof(T));
+      try {
+        construct_from(gap, n, src);
+      } catch (...) {
+        std::memmove(static_cast<void*>(gap), gap + n, tail * sizeof(T));
+        throw;
+      }
+    } else if (tail > n) {
+      // the last n elements move to raw memory, the rest of the tail shifts
+      // within the buffer, and the n freed slots are assigned
+      T* old_end = end();
+      for (size_t i = 0; i != n; ++i) {
+        save_object(std::move((old_end - n)[i]));
+      }
+      std::move_backward(gap, old_end - n, old_end);
+      for (size_t i = 0; i != n; ++i) {
+        gap[i] = src.next();
+      }
+      return begin() + index;
+    } else {
+      // the whole tail moves past the gap; its old slots are assigned and
+      // the rest of the gap is constructed
+      for (size_t i = 0; i != tail; ++i) {
+        try {
+          construct(gap + n + i, std::move(gap[i]));
+        } catch (...) {
+          destroy(gap + n, i);
+          throw;
+        }
+      }
+      try {
+        for (size_t i = 0; i != tail; ++i) {
+          gap[i] = src.next();
+        }
+        construct_from(gap + tail, n - tail, src);
+      } catch (...) {
+        destroy(gap + n, tail);
+        throw;
+      }
+    }
+    size_ += n;
+    return begin() + index;
+  }
+
+  template <typename Source>
+  void construct_from(T* to, size_t cnt, Source& src) {
+    for (size_t i = 0; i != cnt; ++i) {
+      try {
+        construct(to + i, src.next());
+      } catch (...) {
+        destroy(to, i);
+        throw;
+      }
     }
-    operator delete(arr);
   }
 
-  T* data_;
+  T* allocate(size_t const capacity) {
+    if (capacity == 0) {
+      return nullptr;
+    }
+    if constexpr (uses_realloc) {
+      void* result = std::malloc(capacity * sizeof(T));
+      if (result == nullptr) {
+        throw std::bad_alloc();
+      }
+      return static_cast<T*>(result);
+    } else {
+      return traits::allocate(allocator(), capacity);
+    }
+  }
+
+  void deallocate(T* arr, size_t const capacity) {
+    if (arr == nullptr) {
+      return;
+    }
+    if constexpr (uses_realloc) {
+      std::free(arr);
+    } else {
+      traits::deallocate(allocator(), arr, capacity);
+    }
+  }
+
+  template <typename... Args>
+  void construct(T* p, Args&&... args) {
+    traits::construct(allocator(), p, std::forward<Args>(args)...);
+  }
+
+  // Constructs cnt elements in raw memory from the ones at from, moving them
+  // unless the move may throw, so a failure leaves the source intact (strong
+  // guarantee). Trivially relocatable elements are copied bytewise, so the
+  // source must then be released with destroy_moved.
+  void move_construct(T* from, size_t cnt, T* to) {
+    if constexpr (vector_traits::is_trivially_relocatable<T>::value) {
+      if (cnt != 0) {
+        std::memcpy(static_cast<void*>(to), from, cnt * sizeof(T));
+      }
+      return;
+    }
+    for (size_t i = 0; i != cnt; ++i) {
+      try {
+        construct(to + i, std::move_if_noexcept(from[i]));
+      } catch (...) {
+        destroy(to, i);
+        throw;
+      }
+    }
+  }
+
+  void destroy_moved(T* arr, size_t cnt) {
+    if constexpr (!vector_traits::is_trivially_relocatable<T>::value) {
+      destroy(arr, cnt);
+    }
+  }
+
+  void relocate(T* from, size_t cnt, T* to) {
+    move_construct(from, cnt, to);
+    destroy_moved(from, cnt);
+  }
+
+  // trivially destructible elements are not passed to the allocator
+  void destroy(T* arr, size_t cnt) {
+    if constexpr (!std::is_trivially_destructible<T>::value) {
+      while (cnt > 0) {
+        traits::destroy(allocator(), arr + --cnt);
+      }
+    }
+  }
+
+  template <typename... Args>
+  void save_object(Args&&... args) {
+    construct(storage_.data + size_, std::forward<Args>(args)...);
+    size_++;
+  }
+
+  // the buffer and the allocator, which takes no space if it is empty; it is
+  // not a base of vector, so that its namespace and friends do not join the
+  // lookup of calls taking a vector
+  struct storage : Allocator {
+    explicit storage(Allocator const& alloc) noexcept
+        : Allocator(alloc), data(nullptr) {}
+
+    explicit storage(Allocator&& alloc) noexcept
+        : Allocator(std::move(alloc)), data(nullptr) {}
+
+    T* data;
+  };
+
+  storage storage_;
   size_t size_;
   size_t capacity_;
 };
+
+// a vector is its allocator, a pointer to its buffer and two sizes
+template <typename T, typename Allocator, typename Growth>
+struct vector_traits::is_trivially_relocatable<vector<T, Allocator, Growth>>
+    : is_trivially_relocatable<Allocator> {};